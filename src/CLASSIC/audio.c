@@ -256,6 +256,21 @@ int		xmame_has_mastervolume(void)
 }
 
 
+/******************************************************************************
+ * サウンド出力によるウェイト調整
+ *
+ * int xmame_audio_sync(int target, int frame)
+ *      サウンドデバイスへの出力待ちのサンプル数が target 以下になるまで待ち、
+ *      待つ前の出力待ちのサンプル数を返す。分からない場合や、target に
+ *      frame (1フレーム分のサンプル数) を加えた量がバッファに収まらない
+ *      場合は -1 を返す。
+ *****************************************************************************/
+int		xmame_audio_sync(int target, int frame)
+{
+	return -1;		/* 出力待ちのサンプル数は取得しない */
+}
+
+
 /*===========================================================================*/
 /*              MAME の処理関数から呼び出される、システム依存処理関数        */
 /*===========================================================================*/
@@ -288,6 +303,13 @@ int		xmame_has_mastervolume(void)
  *
  *      戻値は、 osd_start_audio_stream() と同じ
  *
+ * int osd_update_audio_stream_part(INT16 *buffer, int samples)
+ *      サウンドデバイスに、1フレームの途中までの samples 個分を出力する。
+ *      -soundupdate 指定時に、フレームの途中で呼び出される。その場合は、
+ *      フレームの残りの分も osd_update_audio_stream() ではなく、この関数で
+ *      出力される。出力したら真を返す。途中までの出力ができないなら、何も
+ *      せずに偽を返す (以降は、1フレーム毎にまとめて出力される)。
+ *
  * void osd_stop_audio_stream(void)
  *      サウンドデバイスを終了する。
  *      この関数は、エミュレーションの終了時に呼び出される。
@@ -564,6 +586,12 @@ int osd_update_audio_stream(INT16 *buffer)
 	return sound_samples_per_frame;
 }
 
+// the stream is fed a whole frame at a time
+int osd_update_audio_stream_part(INT16 *buffer, int samples)
+{
+	return FALSE;
+}
+
 void osd_stop_audio_stream(void)
 {
 	if (use_audiodevice == FALSE) { return; }
@@ -830,6 +830,53 @@ int	osd_file_stat(const char *pathname)
 
 
 
+/****************************************************************************
+ * ファイルのメモリマップ
+ *	この機能は無いので、常に失敗 (呼び出し側が通常の読み込みで代用する)
+ ****************************************************************************/
+void	*osd_file_map(const char *filename, size_t *size)
+{
+    return NULL;
+}
+
+void	osd_file_unmap(void *addr, size_t size)
+{
+}
+
+
+
+/****************************************************************************
+ * ファイルのサイズと更新時刻の取得
+ *	この機能は無いので、常に失敗 (呼び出し側はキャッシュを使わない)
+ ****************************************************************************/
+int	osd_file_stamp(const char *filename, long *size, long *mtime)
+{
+    return FALSE;
+}
+
+
+
+
+/****************************************************************************
+ * ファイルの置き換え
+ *	rename() が上書きしない環境もあるので、その場合は消してからやり直す
+ ****************************************************************************/
+int	osd_file_replace(const char *tmpname, const char *filename)
+{
+    if (rename(tmpname, filename) == 0) {
+	return TRUE;
+    }
+    remove(filename);
+    if (rename(tmpname, filename) == 0) {
+	return TRUE;
+    }
+
+    remove(tmpname);
+    return FALSE;
+}
+
+
+
 
 
 
@@ -13,11 +13,18 @@
 #include <dirent.h>
 #include <unistd.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 #include "quasi88.h"
 #include "initval.h"
 #include "file-op.h"
 #include "menu.h"
+#include "stats.h"
+
+#ifdef	USE_ZLIB
+#include <zlib.h>
+#endif
 
 
 /*****************************************************************************/
@@ -117,6 +124,9 @@ int	osd_kanji_code(void)
  * ファイルポインタを返し、他の場合はオープン失敗として NULL を返す。
  */
 
+typedef	struct	T_DISK_MEM_STRUCT	T_DISK_MEM;
+typedef	struct	T_DISK_GZ_STRUCT	T_DISK_GZ;
+
 struct OSD_FILE_STRUCT {
 
     FILE	*fp;			/* !=NULL なら使用中	*/
@@ -124,6 +134,8 @@ struct OSD_FILE_STRUCT {
     int		type;			/* ファイル種別		*/
     char	mode[4];		/* 開いた際の、モード	*/
 
+    T_DISK_MEM	*mem;			/* !=NULL ならメモリ展開 */
+    T_DISK_GZ	*gz;			/* !=NULL なら圧縮イメージ */
 };
 
 #define	MAX_STREAM	8
@@ -131,12 +143,658 @@ static	OSD_FILE	osd_stream[ MAX_STREAM ];
 
 
 
+/*----------------------------------------------------------------------
+ * ディスクイメージのメモリ展開 (-diskjournal / -diskoverlay 指定時)
+ *
+ *	ディスクイメージは、開いた時にメモリに全て読み込み、以降の読み書きは
+ *	メモリ上で行う。書き込んだ内容は、ジャーナルファイルに追記していき、
+ *	osd_fflush() の度にまとめて出力する。(セクタ毎の fseek/fwrite が
+ *	なくなり、1回の write で済む)
+ *
+ *	-diskjournal の場合、ジャーナルは <イメージ名>.jnl とする。
+ *	ファイルを閉じる時に、全体を一時ファイルに書き出してから rename して
+ *	イメージを更新し、ジャーナルを削除する。
+ *
+ *	-diskoverlay <dir> の場合、イメージ自体は読み出し専用で開き、一切
+ *	更新しない。ジャーナルは <dir>/<イメージのファイル名>.<XXXXXXXX>.jnl
+ *	(XXXXXXXX はイメージのフルパスのハッシュ値。別のディレクトリにある同名
+ *	のイメージと区別する) とし、ファイルを閉じる時に、書き換えた部分だけ
+ *	に整理したものに置き換える。
+ *	これにより、1つのイメージを、複数の QUASI88 で共有できる。
+ *
+ *	一時ファイルから rename する際は、元のファイルの属性 (パーミッション・
+ *	所有者) を引き継ぐ。シンボリックリンクの場合は、リンク先を置き換える。
+ *
+ *	ジャーナルのヘッダには元のイメージのサイズとハッシュを記録し、
+ *	一致しない場合 (イメージが別途更新された場合) は、ジャーナルを
+ *	無視する。各レコードにもハッシュを付けておき、途中で異常終了して
+ *	壊れたレコード以降は、無視する。
+ *
+ *	ジャーナル	ヘッダ	"Q88JNL" + 0x00 + 0x00	8バイト
+ *				元のイメージのサイズ	4バイト
+ *				元のイメージのハッシュ	4バイト
+ *			レコード オフセット		4バイト
+ *				 データ長		4バイト
+ *				 ハッシュ		4バイト
+ *				 データ			データ長バイト
+ *			レコード ……
+ *	(整数値は、ホストのバイトオーダー)
+ *----------------------------------------------------------------------*/
+#define	JNL_MAGIC	"Q88JNL\0"
+#define	JNL_HEADER	(16)
+#define	JNL_RECORD	(12)
+#define	JNL_BLOCK	(256)		/* 書き換えた部分を管理する単位	*/
+
+struct	T_DISK_MEM_STRUCT {
+
+    byte	*buf;			/* イメージの内容		*/
+    long	size;			/* イメージのサイズ		*/
+    long	alloc;			/* buf の確保サイズ		*/
+    long	pos;			/* 現在のファイル位置		*/
+    byte	*dirty;			/* 書き換えたブロック (JNL_BLOCK毎) */
+    int		modified;		/* ファイルに未反映の書き換えあり */
+
+    long	base_size;		/* 元のイメージのサイズ		*/
+    bit32	base_hash;		/* 元のイメージのハッシュ	*/
+
+    FILE	*jfp;			/* ジャーナル (書き込み時に開く)*/
+    long	jsize;			/* ジャーナルの有効なサイズ	*/
+
+    char	path [ OSD_MAX_FILENAME ];	/* イメージのパス	*/
+    char	jpath[ OSD_MAX_FILENAME ];	/* ジャーナルのパス	*/
+
+    struct stat	*sb;			/* osd_fopen の同一ファイル判定用 */
+};
+
+
+static	bit32	mem_hash(bit32 h, const void *ptr, long size)
+{
+    const byte *p = (const byte *)ptr;
+
+    while (size--) {			/* FNV-1a (32bit) */
+	h ^= *p++;
+	h *= 16777619u;
+    }
+    return h;
+}
+
+/* buf の確保サイズを、size 以上にする */
+static	int	mem_reserve(T_DISK_MEM *m, long size)
+{
+    long  alloc;
+    byte  *buf, *dirty;
+
+    if (size <= m->alloc) return TRUE;
+
+    alloc = (m->alloc) ? m->alloc : 0x10000;
+    while (alloc < size) alloc *= 2;
+
+    buf   = (byte *)realloc(m->buf, alloc);
+    if (buf == NULL) return FALSE;
+    m->buf = buf;
+
+    dirty = (byte *)realloc(m->dirty, alloc / JNL_BLOCK);
+    if (dirty == NULL) return FALSE;
+    memset(dirty + m->alloc / JNL_BLOCK, 0, (alloc - m->alloc) / JNL_BLOCK);
+    m->dirty = dirty;
+
+    m->alloc = alloc;
+    return TRUE;
+}
+
+/* メモリ上のイメージの offset から len バイトを書き換える */
+static	int	mem_store(T_DISK_MEM *m, long offset, const void *ptr, long len)
+{
+    long i;
+
+    if (mem_reserve(m, offset + len) == FALSE) return FALSE;
+
+    if (offset > m->size) {			/* 末尾より先は 0 で埋める */
+	memset(m->buf + m->size, 0, offset - m->size);
+    }
+    memcpy(m->buf + offset, ptr, len);
+    if (m->size < offset + len) {
+	m->size = offset + len;
+    }
+
+    for (i = offset / JNL_BLOCK; i <= (offset + len - 1) / JNL_BLOCK; i++) {
+	m->dirty[i] = 1;
+    }
+    return TRUE;
+}
+
+
+/* ジャーナルのパス名を生成する */
+static	int	mem_journal_path(T_DISK_MEM *m)
+{
+    const char *name;
+    char  *real, suffix[16];
+    bit32 h;
+
+    if (dir_disk_overlay) {
+	if ((name = strrchr(m->path, '/'))) name ++;
+	else                                name = m->path;
+
+	/* 同名の別イメージと区別するため、フルパスのハッシュを付ける */
+	if ((real = realpath(m->path, NULL))) {
+	    h = mem_hash(2166136261u, real, strlen(real));
+	    free(real);
+	} else {
+	    h = mem_hash(2166136261u, m->path, strlen(m->path));
+	}
+
+	if (strlen(dir_disk_overlay) + strlen(name) + 14 >= OSD_MAX_FILENAME) {
+	    return FALSE;
+	}
+	sprintf(suffix, ".%08lx.jnl", (unsigned long) h);
+	strcpy(m->jpath, dir_disk_overlay);
+	strcat(m->jpath, "/");
+	strcat(m->jpath, name);
+	strcat(m->jpath, suffix);
+    } else {
+	if (strlen(m->path) + 4 >= OSD_MAX_FILENAME) {
+	    return FALSE;
+	}
+	strcpy(m->jpath, m->path);
+	strcat(m->jpath, ".jnl");
+    }
+    return TRUE;
+}
+
+/* ジャーナルがあれば、その内容をメモリ上のイメージに反映する */
+static	void	mem_journal_replay(T_DISK_MEM *m)
+{
+    FILE  *fp;
+    byte  hdr[ JNL_HEADER ];
+    bit32 rec[ 3 ], h;
+    byte  *data = NULL;
+    long  len;
+
+    m->jsize = 0;
+
+    if ((fp = fopen(m->jpath, "rb")) == NULL) return;
+
+    if (fread(hdr, 1, JNL_HEADER, fp) != JNL_HEADER          ||
+	memcmp(hdr, JNL_MAGIC, 8) != 0                        ||
+	((bit32 *)hdr)[2] != (bit32) m->base_size              ||
+	((bit32 *)hdr)[3] != m->base_hash) {
+
+	if (verbose_fdc) printf("journal %s : ignored\n", m->jpath);
+	fclose(fp);
+	return;
+    }
+    m->jsize = JNL_HEADER;
+
+    while (fread(rec, sizeof(bit32), 3, fp) == 3) {
+	len = (long) rec[1];
+	if (len <= 0 || len > 0x1000000) break;
+
+	data = (byte *)realloc(data, len);
+	if (data == NULL) break;
+	if (fread(data, 1, len, fp) != (size_t) len) break;
+
+	h = mem_hash(2166136261u, rec, sizeof(bit32) * 2);
+	h = mem_hash(h, data, len);
+	if (h != rec[2]) break;			/* 壊れたレコード以降は無視 */
+
+	if (mem_store(m, (long) rec[0], data, len) == FALSE) break;
+	m->jsize += JNL_RECORD + len;
+    }
+
+    free(data);
+    fclose(fp);
+
+    if (verbose_fdc) printf("journal %s : %ld bytes\n", m->jpath, m->jsize);
+}
+
+/* ジャーナルにレコードを追記する (実際の出力は osd_fflush 時) */
+static	int	mem_journal_add(T_DISK_MEM *m, long offset, const void *ptr, long len)
+{
+    byte  hdr[ JNL_HEADER ];
+    bit32 rec[ 3 ];
+
+    if (m->jfp == NULL) {
+
+	if (m->jsize > 0 &&			/* 有効なジャーナルに追記 */
+	    (m->jfp = fopen(m->jpath, "r+b"))) {
+	    if (ftruncate(fileno(m->jfp), m->jsize) != 0 ||
+		fseek(m->jfp, m->jsize, SEEK_SET) != 0) {
+		fclose(m->jfp);
+		m->jfp = NULL;
+	    }
+	}
+	if (m->jfp == NULL) {			/* ジャーナルを新規作成 */
+	    if ((m->jfp = fopen(m->jpath, "wb")) == NULL) return FALSE;
+	    memcpy(hdr, JNL_MAGIC, 8);
+	    ((bit32 *)hdr)[2] = (bit32) m->base_size;
+	    ((bit32 *)hdr)[3] = m->base_hash;
+	    fwrite(hdr, 1, JNL_HEADER, m->jfp);
+	    m->jsize = JNL_HEADER;
+	}
+    }
+
+    rec[0] = (bit32) offset;
+    rec[1] = (bit32) len;
+    rec[2] = mem_hash(mem_hash(2166136261u, rec, sizeof(bit32) * 2), ptr, len);
+
+    if (fwrite(rec, sizeof(bit32), 3, m->jfp) != 3 ||
+	fwrite(ptr, 1, len, m->jfp) != (size_t) len) {
+	return FALSE;
+    }
+    m->jsize += JNL_RECORD + len;
+    return TRUE;
+}
+
+
+/* data を、一時ファイル経由で path に置き換える */
+static	int	mem_replace_file(const char *path,
+				 const void *hdr, long hdr_size,
+				 const T_DISK_MEM *m, int only_dirty)
+{
+    char  tmp[ OSD_MAX_FILENAME + 8 ];
+    char  *real;
+    FILE  *fp;
+    struct stat sb;
+    bit32 rec[ 3 ];
+    long  i, j, n;
+    int   ok = TRUE;
+
+    /* シンボリックリンクなら、リンク先を置き換える */
+    if ((real = realpath(path, NULL))) {
+	if (strlen(real) < OSD_MAX_FILENAME) {
+	    path = real;
+	}
+    }
+
+    sprintf(tmp, "%s.tmp", path);
+    if ((fp = fopen(tmp, "wb")) == NULL) {
+	free(real);
+	return FALSE;
+    }
+
+    /* 元のファイルの属性を引き継ぐ (所有者は、変えられなければそのまま) */
+    if (stat(path, &sb) == 0) {
+	if (fchown(fileno(fp), sb.st_uid, sb.st_gid) != 0) {
+	    ;
+	}
+	fchmod(fileno(fp), sb.st_mode & 07777);
+    }
+
+    if (hdr_size && fwrite(hdr, 1, hdr_size, fp) != (size_t) hdr_size) {
+	ok = FALSE;
+    }
+
+    if (only_dirty == FALSE) {			/* 全体を出力 */
+	if (fwrite(m->buf, 1, m->size, fp) != (size_t) m->size) ok = FALSE;
+
+    } else {					/* 書き換えた部分だけ出力 */
+	n = (m->size + JNL_BLOCK - 1) / JNL_BLOCK;
+	for (i = 0; i < n && ok; i = j) {
+	    if (m->dirty[i] == 0) { j = i + 1;  continue; }
+	    for (j = i; j < n && m->dirty[j]; j++) ;
+
+	    rec[0] = (bit32) (i * JNL_BLOCK);
+	    rec[1] = (bit32) (((j * JNL_BLOCK < m->size) ? j * JNL_BLOCK
+							  : m->size) - rec[0]);
+	    rec[2] = mem_hash(mem_hash(2166136261u, rec, sizeof(bit32) * 2),
+			      m->buf + rec[0], rec[1]);
+	    if (fwrite(rec, sizeof(bit32), 3, fp) != 3 ||
+		fwrite(m->buf + rec[0], 1, rec[1], fp) != rec[1]) ok = FALSE;
+	}
+    }
+
+    if (fflush(fp) != 0 || fsync(fileno(fp)) != 0) ok = FALSE;
+    if (fclose(fp) != 0) ok = FALSE;
+
+    if (ok && rename(tmp, path) == 0) {
+	free(real);
+	return TRUE;
+    }
+
+    remove(tmp);
+    free(real);
+    return FALSE;
+}
+
+/* メモリ上のイメージを、ファイルに反映する */
+static	void	mem_commit(T_DISK_MEM *m)
+{
+    byte hdr[ JNL_HEADER ];
+
+    if (m->jfp) {
+	fclose(m->jfp);
+	m->jfp = NULL;
+    }
+
+    if (dir_disk_overlay == NULL) {
+
+	/* イメージ全体を置き換えたら、ジャーナルは不要 */
+	if (mem_replace_file(m->path, NULL, 0, m, FALSE)) {
+	    /* rename で別の inode になったので、同一ファイル判定用に更新 */
+	    if (m->sb) {
+		stat(m->path, m->sb);
+	    }
+	    remove(m->jpath);
+	    m->base_size = m->size;
+	    m->base_hash = mem_hash(2166136261u, m->buf, m->size);
+	    memset(m->dirty, 0, m->alloc / JNL_BLOCK);
+	    m->jsize = 0;
+	} else {
+	    printf("Disk image commit failed (%s)\n", m->path);
+	}
+
+    } else {
+
+	/* ジャーナルを、書き換えた部分だけに整理する */
+	memcpy(hdr, JNL_MAGIC, 8);
+	((bit32 *)hdr)[2] = (bit32) m->base_size;
+	((bit32 *)hdr)[3] = m->base_hash;
+	if (mem_replace_file(m->jpath, hdr, JNL_HEADER, m, TRUE)) {
+	    struct stat sb;
+	    m->jsize = (stat(m->jpath, &sb) == 0) ? (long) sb.st_size : 0;
+	} else {
+	    printf("Disk overlay commit failed (%s)\n", m->jpath);
+	}
+    }
+
+    m->modified = FALSE;
+}
+
+
+static	T_DISK_MEM	*mem_open(FILE *fp, const char *path)
+{
+    T_DISK_MEM *m;
+    struct stat sb;
+
+    if (strlen(path) >= OSD_MAX_FILENAME) return NULL;
+    if (fstat(fileno(fp), &sb) != 0)      return NULL;
+
+    m = (T_DISK_MEM *)calloc(1, sizeof(T_DISK_MEM));
+    if (m == NULL) return NULL;
+
+    strcpy(m->path, path);
+
+    if (mem_reserve(m, (long) sb.st_size + 1)                   == FALSE ||
+	fread(m->buf, 1, sb.st_size, fp) != (size_t) sb.st_size         ||
+	mem_journal_path(m)                                     == FALSE) {
+	free(m->buf);
+	free(m->dirty);
+	free(m);
+	return NULL;
+    }
+    m->size      = (long) sb.st_size;
+    m->base_size = m->size;
+    m->base_hash = mem_hash(2166136261u, m->buf, m->size);
+
+    mem_journal_replay(m);
+
+    /* ジャーナルの内容は、まだイメージに反映されていない */
+    if (m->jsize > 0 && dir_disk_overlay == NULL) {
+	m->modified = TRUE;
+    }
+    return m;
+}
+
+static	int	mem_close(T_DISK_MEM *m, int writable)
+{
+    if (writable && m->modified) {
+	mem_commit(m);
+    }
+    if (m->jfp) fclose(m->jfp);
+    free(m->buf);
+    free(m->dirty);
+    free(m);
+    return 0;
+}
+
+static	int	mem_flush(T_DISK_MEM *m)
+{
+    if (m->jfp == NULL) return 0;
+
+    if (fflush(m->jfp) != 0) return EOF;
+
+    /* ジャーナルが大きくなりすぎたら、反映してしまう */
+    if (m->jsize > m->size * 2 + 0x10000) {
+	mem_commit(m);
+    }
+    return 0;
+}
+
+static	size_t	mem_read(void *ptr, size_t size, size_t nobj, T_DISK_MEM *m)
+{
+    size_t n;
+
+    if (size == 0 || m->pos >= m->size) return 0;
+
+    n = (size_t) (m->size - m->pos) / size;
+    if (n > nobj) n = nobj;
+
+    memcpy(ptr, m->buf + m->pos, n * size);
+    m->pos += n * size;
+    return n;
+}
+
+static	size_t	mem_write(const void *ptr, size_t size, size_t nobj,
+			  T_DISK_MEM *m)
+{
+    long len = (long) (size * nobj);
+
+    if (len == 0) return 0;
+
+    if (mem_journal_add(m, m->pos, ptr, len) == FALSE ||
+	mem_store(m, m->pos, ptr, len)       == FALSE) {
+	return 0;
+    }
+    m->pos += len;
+    m->modified = TRUE;
+    return nobj;
+}
+
+
+
+/*----------------------------------------------------------------------
+ * 圧縮されたディスクイメージ (gzip 形式。USE_ZLIB 指定時)
+ *
+ *	開いた時に全体を一度だけ展開しながら、GZ_BLOCK バイト毎のブロックに
+ *	区切って、ブロック毎に個別に圧縮し直してメモリに保持する。(ほとんど
+ *	が空きセクタのイメージなら、ごく小さくなる。全て同じ値のブロックは、
+ *	その値だけを保持する)
+ *
+ *	読み出し時は、必要なブロックだけを展開し、最近使った GZ_CACHE 個の
+ *	ブロックをキャッシュしておく。このため、複数イメージを含む大きな
+ *	ファイルでも、使用メモリは (圧縮後のサイズ + キャッシュ) で済む。
+ *	展開したブロック数は、動作状況カウンタ (disk_inflate) で確認できる。
+ *
+ *	圧縮イメージは、読み出し専用とする。("r+b" では開けない)
+ *----------------------------------------------------------------------*/
+#ifdef	USE_ZLIB
+
+#define	GZ_BLOCK	(0x2000)	/* ブロックのサイズ (2D の約1トラック)*/
+#define	GZ_CACHE	(16)		/* キャッシュするブロック数	*/
+
+typedef	struct {
+    byte	*zbuf;			/* 圧縮したデータ (NULLなら全て fill)*/
+    long	zlen;			/* 圧縮したデータのサイズ	*/
+    byte	fill;			/* 全て同じ値の場合の、その値	*/
+} T_GZ_BLOCK;
+
+struct	T_DISK_GZ_STRUCT {
+
+    long	size;			/* 展開後のサイズ		*/
+    long	pos;			/* 現在のファイル位置		*/
+
+    long	nr_block;		/* ブロック数			*/
+    T_GZ_BLOCK	*block;			/* ブロック毎の情報		*/
+
+    struct {				/* 展開済みのブロック		*/
+	long		no;		/*	ブロック番号 (-1 なら空き) */
+	unsigned long	used;		/*	最後に使った時刻	*/
+	byte		data[ GZ_BLOCK ];
+    } cache[ GZ_CACHE ];
+    unsigned long	clock;
+};
+
+
+/* gzip 形式のファイルなら真 */
+static	int	gz_check(FILE *fp)
+{
+    byte c[2];
+    int  ok;
+
+    ok = (fread(c, 1, 2, fp) == 2 && c[0] == 0x1f && c[1] == 0x8b);
+    rewind(fp);
+    return ok;
+}
+
+static	void	gz_free(T_DISK_GZ *g)
+{
+    long i;
+
+    for (i = 0; i < g->nr_block; i++) {
+	free(g->block[i].zbuf);
+    }
+    free(g->block);
+    free(g);
+}
+
+/* 展開しながら、ブロック毎に圧縮し直す */
+static	T_DISK_GZ	*gz_open(FILE *fp)
+{
+    T_DISK_GZ  *g;
+    T_GZ_BLOCK *b;
+    gzFile     gzf;
+    byte       data[ GZ_BLOCK ];
+    byte       *tmp;
+    uLongf     zlen;
+    long       n, i;
+    int        fd;
+
+    if ((fd = dup(fileno(fp))) < 0) return NULL;
+    if ((gzf = gzdopen(fd, "rb")) == NULL) {
+	close(fd);
+	return NULL;
+    }
+
+    g   = (T_DISK_GZ *)calloc(1, sizeof(T_DISK_GZ));
+    tmp = (byte *)malloc(compressBound(GZ_BLOCK));
+    if (g == NULL || tmp == NULL) goto ERR;
+
+    for (;;) {
+	n = gzread(gzf, data, GZ_BLOCK);
+	if (n < 0) goto ERR;
+	if (n == 0) break;
+	if (n < GZ_BLOCK) memset(data + n, 0, GZ_BLOCK - n);
+
+	if ((g->nr_block & 63) == 0) {
+	    b = (T_GZ_BLOCK *)realloc(g->block,
+				      sizeof(T_GZ_BLOCK) * (g->nr_block + 64));
+	    if (b == NULL) goto ERR;
+	    g->block = b;
+	}
+	b = &g->block[ g->nr_block ++ ];
+	b->zbuf = NULL;
+	b->zlen = 0;
+	b->fill = data[0];
+	g->size += n;
+
+	for (i = 1; i < GZ_BLOCK; i++) {
+	    if (data[i] != data[0]) break;
+	}
+	if (i < GZ_BLOCK) {
+	    zlen = compressBound(GZ_BLOCK);
+	    if (compress2(tmp, &zlen, data, GZ_BLOCK, Z_BEST_SPEED) != Z_OK ||
+		(b->zbuf = (byte *)malloc(zlen)) == NULL) goto ERR;
+	    memcpy(b->zbuf, tmp, zlen);
+	    b->zlen = (long) zlen;
+	}
+
+	if (n < GZ_BLOCK) break;
+    }
+
+    for (i = 0; i < GZ_CACHE; i++) {
+	g->cache[i].no = -1;
+    }
+
+    free(tmp);
+    gzclose(gzf);
+    return g;
+
+ ERR:
+    if (g) gz_free(g);
+    free(tmp);
+    gzclose(gzf);
+    return NULL;
+}
+
+/* ブロック no の展開済みデータを返す */
+static	const byte	*gz_block(T_DISK_GZ *g, long no)
+{
+    int    i, c = 0;
+    uLongf len = GZ_BLOCK;
+
+    for (i = 0; i < GZ_CACHE; i++) {
+	if (g->cache[i].no == no) {
+	    g->cache[i].used = ++ g->clock;
+	    return g->cache[i].data;
+	}
+	if (g->cache[i].used < g->cache[c].used) c = i;
+    }
+
+    /* 最も長く使っていないものを追い出して、展開する。
+       展開に失敗しても古いブロックとして使われないよう、先に無効にする */
+    g->cache[c].no = -1;
+    if (g->block[no].zbuf == NULL) {
+	memset(g->cache[c].data, g->block[no].fill, GZ_BLOCK);
+    } else {
+	if (uncompress(g->cache[c].data, &len,
+		       g->block[no].zbuf, g->block[no].zlen) != Z_OK) {
+	    return NULL;
+	}
+	STATS_INC(STATS_DISK_INFLATE);
+    }
+    g->cache[c].no   = no;
+    g->cache[c].used = ++ g->clock;
+    return g->cache[c].data;
+}
+
+static	size_t	gz_read(void *ptr, size_t size, size_t nobj, T_DISK_GZ *g)
+{
+    const byte *data;
+    byte  *p = (byte *)ptr;
+    long  len, ofs, n;
+    size_t nr;
+
+    if (size == 0 || g->pos >= g->size) return 0;
+
+    nr = (size_t) (g->size - g->pos) / size;
+    if (nr > nobj) nr = nobj;
+
+    for (len = (long) (nr * size); len > 0; len -= n) {
+	if ((data = gz_block(g, g->pos / GZ_BLOCK)) == NULL) {
+	    return (p - (byte *)ptr) / size;
+	}
+	ofs = g->pos % GZ_BLOCK;
+	n   = GZ_BLOCK - ofs;
+	if (n > len) n = len;
+
+	memcpy(p, data + ofs, n);
+	p      += n;
+	g->pos += n;
+    }
+    return nr;
+}
+
+#endif	/* USE_ZLIB */
+
+
+
 OSD_FILE *osd_fopen(int type, const char *path, const char *mode)
 {
     int i;
     struct stat	sb;
     OSD_FILE	*st;
     int		stat_ok;
+    int		use_mem;
 
     st = NULL;
     for (i=0; i<MAX_STREAM; i++) {	/* 空きバッファを探す */
@@ -155,6 +813,9 @@ OSD_FILE *osd_fopen(int type, const char *path, const char *mode)
 	stat_ok = TRUE;
     }
 
+    /* ディスクイメージを読み書きする場合は、必要に応じてメモリ展開 */
+    use_mem = (type == FTYPE_DISK && mode[0] == 'r' &&
+	       (disk_journal || dir_disk_overlay));
 
 
     switch (type) {
@@ -192,7 +853,12 @@ OSD_FILE *osd_fopen(int type, const char *path, const char *mode)
 
 
     default:
-	st->fp = fopen(path, mode);	/* ファイルを開く */
+	/* オーバーレイ時は、元のイメージには書き込まない */
+	if (use_mem && dir_disk_overlay) {
+	    st->fp = fopen(path, "rb");
+	} else {
+	    st->fp = fopen(path, mode);	/* ファイルを開く */
+	}
 
 	if (st->fp) {
 
@@ -204,8 +870,32 @@ OSD_FILE *osd_fopen(int type, const char *path, const char *mode)
 		}
 	    }
 
+	    st->mem = NULL;
+	    st->gz  = NULL;
+#ifdef	USE_ZLIB
+	    if (type == FTYPE_DISK && gz_check(st->fp)) {
+		if (strchr(mode, '+') ||	/* 圧縮イメージは読み出し専用 */
+		    (st->gz = gz_open(st->fp)) == NULL) {
+		    fclose(st->fp);
+		    st->fp = NULL;
+		    return NULL;
+		}
+		use_mem = FALSE;
+	    }
+#endif
+	    if (use_mem) {
+		if ((st->mem = mem_open(st->fp, path)) == NULL) {
+		    fclose(st->fp);
+		    st->fp = NULL;
+		    return NULL;
+		}
+	    }
+
 	    st->type = type;
 	    st->sb   = sb;
+	    if (st->mem) {
+		st->mem->sb = &st->sb;
+	    }
 	    strncpy(st->mode, mode, sizeof(st->mode));
 	    return st;
 
@@ -222,6 +912,17 @@ int	osd_fclose(OSD_FILE *stream)
 {
     FILE *fp = stream->fp;
 
+    if (stream->mem) {
+	mem_close(stream->mem, (strchr(stream->mode, '+') != NULL));
+	stream->mem = NULL;
+    }
+#ifdef	USE_ZLIB
+    if (stream->gz) {
+	gz_free(stream->gz);
+	stream->gz = NULL;
+    }
+#endif
+
     stream->fp = NULL;
     return fclose(fp);
 }
@@ -231,6 +932,8 @@ int	osd_fclose(OSD_FILE *stream)
 int	osd_fflush(OSD_FILE *stream)
 {
     if (stream == NULL) return fflush(NULL);
+    else if (stream->mem) return mem_flush(stream->mem);
+    else if (stream->gz)  return 0;
     else                return fflush(stream->fp);
 }
 
@@ -238,6 +941,28 @@ int	osd_fflush(OSD_FILE *stream)
 
 int	osd_fseek(OSD_FILE *stream, long offset, int whence)
 {
+    if (stream->mem) {
+	T_DISK_MEM *m = stream->mem;
+	switch (whence) {
+	case SEEK_CUR:	offset += m->pos;	break;
+	case SEEK_END:	offset += m->size;	break;
+	}
+	if (offset < 0) return -1;
+	m->pos = offset;
+	return 0;
+    }
+#ifdef	USE_ZLIB
+    if (stream->gz) {
+	T_DISK_GZ *g = stream->gz;
+	switch (whence) {
+	case SEEK_CUR:	offset += g->pos;	break;
+	case SEEK_END:	offset += g->size;	break;
+	}
+	if (offset < 0) return -1;
+	g->pos = offset;
+	return 0;
+    }
+#endif
     return fseek(stream->fp, offset, whence);
 }
 
@@ -245,6 +970,10 @@ int	osd_fseek(OSD_FILE *stream, long offset, int whence)
 
 long	osd_ftell(OSD_FILE *stream)
 {
+    if (stream->mem) return stream->mem->pos;
+#ifdef	USE_ZLIB
+    if (stream->gz)  return stream->gz->pos;
+#endif
     return ftell(stream->fp);
 }
 
@@ -260,6 +989,10 @@ void	osd_rewind(OSD_FILE *stream)
 
 size_t	osd_fread(void *ptr, size_t size, size_t nobj, OSD_FILE *stream)
 {
+    if (stream->mem) return mem_read(ptr, size, nobj, stream->mem);
+#ifdef	USE_ZLIB
+    if (stream->gz)  return gz_read(ptr, size, nobj, stream->gz);
+#endif
     return fread(ptr, size, nobj, stream->fp);
 }
 
@@ -267,6 +1000,11 @@ size_t	osd_fread(void *ptr, size_t size, size_t nobj, OSD_FILE *stream)
 
 size_t	osd_fwrite(const void *ptr, size_t size, size_t nobj, OSD_FILE *stream)
 {
+    if (stream->mem) {
+	if (strchr(stream->mode, '+') == NULL) return 0;
+	return mem_write(ptr, size, nobj, stream->mem);
+    }
+    if (stream->gz) return 0;
     return fwrite(ptr, size, nobj, stream->fp);
 }
 
@@ -274,25 +1012,33 @@ size_t	osd_fwrite(const void *ptr, size_t size, size_t nobj, OSD_FILE *stream)
 
 int	osd_fputc(int c, OSD_FILE *stream)
 {
+    if (stream->mem || stream->gz) {
+	byte b = (byte) c;
+	return (osd_fwrite(&b, 1, 1, stream) == 1) ? (c & 0xff) : EOF;
+    }
     return fputc(c, stream->fp);
 }
 
 
 int	osd_fgetc(OSD_FILE *stream)
 {
+    if (stream->mem || stream->gz) {
+	byte b;
+	return (osd_fread(&b, 1, 1, stream) == 1) ? b : EOF;
+    }
     return fgetc(stream->fp);
 }
 
 
 char	*osd_fgets(char *str, int size, OSD_FILE *stream)
 {
-    return fgets(str, size, stream->fp);
+    return fgets(str, size, stream->fp);	/* ディスクイメージでは未使用 */
 }
 
 
 int	osd_fputs(const char *str, OSD_FILE *stream)
 {
-    return fputs(str, stream->fp);
+    return fputs(str, stream->fp);		/* ディスクイメージでは未使用 */
 }
 
 
@@ -394,6 +1140,14 @@ T_DIR_INFO	*osd_opendir(const char *filename)
 
 	    dir->entry[i].type = FILE_STAT_FILE; /*  (失敗したら FILE 扱い) */
 
+#ifdef	DT_DIR					/* 種類が分かれば stat しない */
+	    if (dp->d_type == DT_DIR) {
+		dir->entry[i].type = FILE_STAT_DIR;
+		fullname = NULL;
+	    } else if (dp->d_type != DT_UNKNOWN && dp->d_type != DT_LNK) {
+		fullname = NULL;
+	    } else
+#endif
 	    fullname = (char*)malloc(strlen(filename)+1 +strlen(dp->d_name)+1);
 
 	    if (fullname) {
@@ -757,6 +1511,90 @@ int	osd_file_stat(const char *pathname)
 
 
 
+/****************************************************************************
+ * ファイルのメモリマップ
+ *	読み出し専用の共有マップなので、同じファイルをマップした複数の
+ *	プロセスで、物理メモリが共有される
+ ****************************************************************************/
+void	*osd_file_map(const char *filename, size_t *size)
+{
+    struct stat sb;
+    void *addr;
+    int fd;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+	return NULL;
+    }
+
+    if (fstat(fd, &sb) || sb.st_size <= 0) {
+	close(fd);
+	return NULL;
+    }
+
+    addr = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);				/* マップ後は閉じてもよい */
+
+    if (addr == MAP_FAILED) {
+	return NULL;
+    }
+
+    *size = (size_t)sb.st_size;
+    return addr;
+}
+
+void	osd_file_unmap(void *addr, size_t size)
+{
+    if (addr) {
+	munmap(addr, size);
+    }
+}
+
+
+
+/****************************************************************************
+ * ファイルのサイズと更新時刻の取得
+ ****************************************************************************/
+int	osd_file_stamp(const char *filename, long *size, long *mtime)
+{
+    struct stat sb;
+
+    if (stat(filename, &sb) || S_ISREG(sb.st_mode) == 0) {
+	return FALSE;
+    }
+
+    *size  = (long) sb.st_size;
+    *mtime = (long) sb.st_mtime;
+    return TRUE;
+}
+
+
+
+/****************************************************************************
+ * ファイルの置き換え
+ *	rename で置き換えるので、filename をマップしているプロセスは、
+ *	元の inode を参照し続ける
+ ****************************************************************************/
+int	osd_file_replace(const char *tmpname, const char *filename)
+{
+    int fd, ok = FALSE;
+
+    if ((fd = open(tmpname, O_RDONLY)) >= 0) {
+	ok = (fsync(fd) == 0);
+	close(fd);
+    }
+
+    if (ok && rename(tmpname, filename) == 0) {
+	return TRUE;
+    }
+
+    remove(tmpname);
+    return FALSE;
+}
+
+
+
+
 
 
 /****************************************************************************
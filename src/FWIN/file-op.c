@@ -933,6 +933,57 @@ int	osd_file_stat(const char *pathname)
 
 
 
+/****************************************************************************
+ * ファイルのメモリマップ
+ *	この機能は無いので、常に失敗 (呼び出し側が通常の読み込みで代用する)
+ ****************************************************************************/
+void	*osd_file_map(const char *filename, size_t *size)
+{
+    return NULL;
+}
+
+void	osd_file_unmap(void *addr, size_t size)
+{
+}
+
+
+
+/****************************************************************************
+ * ファイルのサイズと更新時刻の取得
+ ****************************************************************************/
+int	osd_file_stamp(const char *filename, long *size, long *mtime)
+{
+    struct _stat sb;
+
+    if (_stat(filename, &sb) || (sb.st_mode & _S_IFREG) == 0) {
+	return FALSE;
+    }
+
+    *size  = (long) sb.st_size;
+    *mtime = (long) sb.st_mtime;
+    return TRUE;
+}
+
+
+
+
+/****************************************************************************
+ * ファイルの置き換え
+ *	rename() は上書きしないので、先に filename を消しておく
+ ****************************************************************************/
+int	osd_file_replace(const char *tmpname, const char *filename)
+{
+    remove(filename);
+    if (rename(tmpname, filename) == 0) {
+	return TRUE;
+    }
+
+    remove(tmpname);
+    return FALSE;
+}
+
+
+
 
 
 
@@ -76,6 +76,9 @@ static	const	T_CONFIG_TABLE xmame_options[] =
   { 363, "samples",      X_FIX,  &options.use_samples, 1,                 0,0, OPT_SAVE },
   { 363, "nosamples",    X_FIX,  &options.use_samples, 0,                 0,0, OPT_SAVE },
 
+  { 367, "resample",     X_INT,  &resample_quality, 0, 2,                  0, OPT_SAVE },
+  { 368, "soundupdate",  X_INT,  &sound_update,    0, 8192,                 0, OPT_SAVE },
+
   /* 終端 */
   {   0, NULL,           X_INV,                                       0,0,0,0, 0        },
 };
@@ -120,6 +123,8 @@ void	xmame_config_show_option(void)
   "    -samplevol <level>      Set SAMPLE level to <level> %%, (0 - 100) [100]\n"
   "    -samplefreq <rate>      Set the playback sample-frequency/rate [44100]\n"
   "    -[no]samples            Use/don't use samples (if available) [-nosamples]\n"
+  "    -resample <0|1|2>       Set resampling quality (0:fast 1:normal 2:high) [0]\n"
+  "    -soundupdate <samples>  Send sound every <samples> (0:every frame) [0]\n"
 /*"    -[no]close              Close/no close sound device in MENU mode [-noclose]\n"*/
   );
 }
@@ -222,6 +227,21 @@ int	xmame_has_mastervolume(void)
 }
 
 
+/******************************************************************************
+ * サウンド出力によるウェイト調整
+ *
+ * int xmame_audio_sync(int target, int frame)
+ *      サウンドデバイスへの出力待ちのサンプル数が target 以下になるまで待ち、
+ *      待つ前の出力待ちのサンプル数を返す。分からない場合や、target に
+ *      frame (1フレーム分のサンプル数) を加えた量がバッファに収まらない
+ *      場合は -1 を返す。
+ *****************************************************************************/
+int	xmame_audio_sync(int target, int frame)
+{
+    return -1;
+}
+
+
 /*===========================================================================*/
 /*              MAME の処理関数から呼び出される、システム依存処理関数        */
 /*===========================================================================*/
@@ -254,6 +274,13 @@ int	xmame_has_mastervolume(void)
  *
  *      戻値は、 osd_start_audio_stream() と同じ
  *
+ * int osd_update_audio_stream_part(INT16 *buffer, int samples)
+ *      サウンドデバイスに、1フレームの途中までの samples 個分を出力する。
+ *      -soundupdate 指定時に、フレームの途中で呼び出される。その場合は、
+ *      フレームの残りの分も osd_update_audio_stream() ではなく、この関数で
+ *      出力される。出力したら真を返す。途中までの出力ができないなら、何も
+ *      せずに偽を返す (以降は、1フレーム毎にまとめて出力される)。
+ *
  * void osd_stop_audio_stream(void)
  *      サウンドデバイスを終了する。
  *      この関数は、エミュレーションの終了時に呼び出される。
@@ -289,6 +316,11 @@ int	osd_update_audio_stream(INT16 *buffer)
     return 44100 / DEFAULT_VSYNC_FREQ_HZ;
 }
 
+int	osd_update_audio_stream_part(INT16 *buffer, int samples)
+{
+    return TRUE;
+}
+
 void	osd_stop_audio_stream(void)
 {
 }
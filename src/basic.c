@@ -23,11 +23,14 @@
 #include <ctype.h>
 
 #include "quasi88.h"
+#include "initval.h"
 #include "z80.h"
 #include "memory.h"
+#include "pc88main.h"
 #include "screen.h"
 #include "monitor.h"
 #include "basic.h"
+#include "stats.h"
 
 #define BASIC_MAX_ERR_NUM	4	/* エラー登録可能数		*/
 #define BASIC_MAX_ERR_STR	20	/* エラー表示文字数		*/
@@ -76,6 +79,8 @@ typedef struct {
 
 int basic_mode = FALSE;
 
+char *file_basconv = NULL;		/* 一括変換の指示ファイル */
+
 static z80arch pseudo_z80_cpu;			/* 仮想 CPU               */
 
 static byte *pseudo_ram;			/* 仮想メモリ (MAIN RAM)  */
@@ -200,6 +205,8 @@ static void pseudo_z80_init(void)
 
     pseudo_z80_cpu.intr_update = pseudo_intr_update;
     pseudo_z80_cpu.intr_ack    = pseudo_intr_ack;
+
+    pseudo_z80_cpu.stats_insn  = STATS_BASIC_INSN;
 }
 
 /*------------------------------------------------------*/
@@ -395,7 +402,8 @@ int basic_encode_list(FILE *fp)
     basic_end_addr = READ_WORD(pseudo_ram, basic_end_addr_addr);
     if (basic_end_addr < basic_top_addr) {
 	printf("Error : failed to encode.\n");
-	return(0);
+	size = 0;
+	goto end_basic_encode_list;
     }
     size = basic_end_addr - basic_top_addr + 1;
     memcpy(&main_ram[basic_top_addr], &pseudo_ram[basic_top_addr], size);
@@ -594,4 +602,118 @@ int basic_save_intermediate_code(FILE *fp)
     return(wsize);
 }
 
+
+/*------------------------------------------------------*/
+/* 指示ファイルに従い、BASIC リストを一括変換する	*/
+/*------------------------------------------------------*/
+/*
+ *  エミュレータを起動せずに (メモリ確保・ROM ロードの直後に)、
+ *  1 行に 1 つずつ書かれた変換を順に行う。書式は、
+ *	e <テキストファイル> <中間コードファイル>	… テキストを中間コードに
+ *	d <中間コードファイル> <テキストファイル>	… 中間コードをテキストに
+ *  空行と # で始まる行は無視する。BASIC モードは -n / -v1s 等に従う。
+ *  ファイル名は空白で区切るので、空白を含むファイル名は指定できない。
+ *
+ *  出力は <出力ファイル>.tmp に書いて、変換に成功した場合のみ置き換える。
+ *  失敗した場合、既存の出力ファイルはそのまま残る。
+ *
+ *  仮想 CPU は 1 つだけなので、並列に処理したい場合は、指示ファイルを
+ *  分割して、その数だけ quasi88 を起動すること。
+ *
+ *  戻り値は、失敗した変換の数。
+ */
+int basic_convert_batch(const char *listfile)
+{
+    char line[BASIC_MAX_LINE * 4];
+    char type[4], src[BASIC_MAX_LINE * 2], dst[BASIC_MAX_LINE * 2];
+    char tmp[BASIC_MAX_LINE * 2 + 8];
+    FILE *fp, *fin, *fout;
+    int  line_num = 0, done = 0, failed = 0;
+    int  size;
+
+    if ((fp = fopen(listfile, "r")) == NULL) {
+	printf("file [%s] can't open\n", listfile);
+	return(1);
+    }
+
+    /* 仮想メモリの割り当ては grph_ctrl の N-BASIC 指定のみで決まる */
+    grph_ctrl = (boot_basic == BASIC_N) ? GRPH_CTRL_N : 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+	line_num++;
+	if (sscanf(line, "%3s %511s %511s", type, src, dst) != 3) {
+	    if (sscanf(line, "%3s", type) == 1 && type[0] != '#') {
+		printf("%s:%d : syntax error.\n", listfile, line_num);
+		failed++;
+	    }
+	    continue;
+	}
+	if (type[0] == '#') continue;
+
+	/* ファイルを開く前に確認し、出力ファイルを壊さないようにする */
+	if ((type[0] != 'e' && type[0] != 'd') || type[1] != '\0') {
+	    printf("%s:%d : unknown type '%s'.\n", listfile, line_num, type);
+	    failed++;
+	    continue;
+	}
+
+	if ((fin = fopen(src, "r")) == NULL) {
+	    printf("file [%s] can't open\n", src);
+	    failed++;
+	    continue;
+	}
+	strcpy(tmp, dst);
+	strcat(tmp, ".tmp");
+	if ((fout = fopen(tmp, "w")) == NULL) {
+	    printf("file [%s] can't open\n", tmp);
+	    fclose(fin);
+	    failed++;
+	    continue;
+	}
+
+	switch (type[0]) {
+	case 'e':		/* テキスト → 中間コード */
+	    size = basic_encode_list(fin);
+	    if (size > 0) size = basic_save_intermediate_code(fout);
+	    break;
+	case 'd':		/* 中間コード → テキスト */
+	    size = basic_load_intermediate_code(fin);
+	    if (size > 0) size = basic_decode_list(fout);
+	    break;
+	default:
+	    size = 0;
+	    break;
+	}
+	fclose(fin);
+	if (fclose(fout) != 0) size = 0;
+
+	/* 成功したら置き換える。rename() が上書きしない環境 (Windows) では、
+	   出力ファイルを消してからやり直す */
+	if (size > 0 && rename(tmp, dst) != 0) {
+	    remove(dst);
+	    if (rename(tmp, dst) != 0) {
+		printf("file [%s] can't rename to [%s]\n", tmp, dst);
+		size = 0;
+	    }
+	}
+	if (size <= 0) {
+	    remove(tmp);
+	}
+
+	if (size > 0) {
+	    done++;
+	    if (verbose_proc) printf("Convert [%s] -> [%s] (size %d)\n",
+				     src, dst, size);
+	} else {
+	    printf("Convert [%s] -> [%s] ... FAILED\n", src, dst);
+	    failed++;
+	}
+    }
+    fclose(fp);
+
+    printf("BASIC convert : %d done, %d failed\n", done, failed);
+
+    return(failed);
+}
+
 #endif	/* USE_MONITOR */
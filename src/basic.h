@@ -2,10 +2,12 @@
 #define BASIC_H_INCLUDED
 
 extern int basic_mode;
+extern char *file_basconv;
 
 int basic_encode_list(FILE *fp);
 int basic_load_intermediate_code(FILE *fp);
 int basic_decode_list(FILE *fp);
 int basic_save_intermediate_code(FILE *fp);
+int basic_convert_batch(const char *listfile);
 
 #endif	/* BASIC_H_INCLUDED */
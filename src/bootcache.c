@@ -0,0 +1,318 @@
+/************************************************************************/
+/*									*/
+/* ブートキャッシュ (起動処理を省略するためのステートファイル)		*/
+/*									*/
+/************************************************************************/
+
+/*
+  ○キャッシュの作成
+	ブートキャッシュが見つからなければ、通常どおり電源投入から起動し、
+	-bootframe で指定したフレーム数を実行した時点 (-bootpc 指定時は、
+	メインCPU の PC がそのアドレスに達した後の最初のフレーム) で、
+	ステートセーブする。それまでに、リセットやステートロード、メニュー
+	への遷移などがあれば、キャッシュは作成しない。
+
+  ○キャッシュの使用
+	起動時に、ROMイメージの内容、ディスクイメージの名前と内容、起動に
+	関わる設定 (BASICモード、ディップスイッチなど)、保存する時点から
+	ハッシュ値を求め、ステートファイル名 boot-XXXXXXXX.sta とする。
+	このファイルがあれば、起動時のステートロード (-resume) と同様に
+	ロードする。いずれかが変わればファイル名が変わるので、古いキャッシュ
+	が使われることはない。
+	ロードに途中で失敗した場合は、起動に関わる設定を元に戻し、キャッシュ
+	を削除して、通常どおり電源投入から起動する (キャッシュは作り直す)。
+
+	クロックやウェイト、CPU の処理方法などの実行時の設定もステートファイル
+	に含まれるが、これらはキーには含めず、ロード後 (成否によらず) に
+	起動時の指定に戻す。
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "quasi88.h"
+#include "initval.h"
+#include "bootcache.h"
+#include "getconf.h"
+
+#include "pc88main.h"
+#include "memory.h"
+#include "soundbd.h"
+#include "suspend.h"
+#include "file-op.h"
+#include "emu.h"
+#include "intr.h"
+#include "event.h"
+
+
+int	use_bootcache   = FALSE;	/* 真ならブートキャッシュを使う	*/
+int	bootcache_frame = 600;		/* 保存するまでのフレーム数	*/
+int	bootcache_pc    = -1;		/* 保存する PC (負なら未指定)	*/
+
+
+static	enum {
+    BC_IDLE,			/* 何もしない			*/
+    BC_WAIT,			/* 保存する時点を待っている	*/
+    BC_REACH			/* 保存する時点に達した		*/
+} bc_state = BC_IDLE;
+
+static	int	bc_frames;	/* 起動後のフレーム数		*/
+static	char	bc_file[ QUASI88_MAX_FILENAME ];	/* キャッシュ名 */
+
+				/* ステートロードで上書きされる実行時の設定 */
+typedef	struct {
+    int		cpu_timing;
+    int		select_main_cpu;
+    int		dual_cpu_count;
+    int		cpu_1_count;
+    int		cpu_slice_us;
+    double	cpu_clock_mhz;
+    double	sound_clock_mhz;
+    double	vsync_freq_hz;
+    int		wait_rate;
+    int		no_wait;
+} T_BC_RUN_CFG;
+
+
+
+/*----------------------------------------------------------------------
+ * キャッシュのキー (ハッシュ値) の算出
+ *----------------------------------------------------------------------*/
+static	bit32	bc_hash(bit32 h, const void *ptr, long size)
+{
+    const byte *p = (const byte *)ptr;
+
+    while (size--) {			/* FNV-1a (32bit) */
+	h ^= *p++;
+	h *= 16777619u;
+    }
+    return h;
+}
+
+static	bit32	bc_hash_int(bit32 h, int v)
+{
+    return bc_hash(h, &v, sizeof(v));
+}
+
+static	bit32	bc_hash_file(bit32 h, const char *filename)
+{
+    byte     buf[ 4096 ];
+    OSD_FILE *fp;
+    size_t   n;
+
+    h = bc_hash(h, filename, strlen(filename) + 1);
+
+    if ((fp = osd_fopen(FTYPE_DISK, filename, "rb"))) {
+	while ((n = osd_fread(buf, sizeof(byte), sizeof(buf), fp)) > 0) {
+	    h = bc_hash(h, buf, (long) n);
+	}
+	osd_fclose(fp);
+    }
+    return h;
+}
+
+static	bit32	bc_key(void)
+{
+    bit32 h = 2166136261u;
+    int   i;
+
+				/* ROMイメージ */
+    h = bc_hash(h, main_rom,        0x8000);
+    h = bc_hash(h, main_rom_ext,    0x2000 * 4);
+    h = bc_hash(h, main_rom_n,      0x8000);
+    h = bc_hash(h, sub_romram,      0x2000);
+    h = bc_hash(h, kanji_rom,       sizeof(byte) * 2 * 65536 * 2);
+    if (use_jisho_rom && jisho_rom) {
+	h = bc_hash(h, jisho_rom,   0x4000 * 32);
+    }
+    h = bc_hash(h, font_mem,        8 * 256 * 2);
+    h = bc_hash(h, font_mem2,       8 * 256 * 2);
+    h = bc_hash(h, font_mem3,       8 * 256 * 2);
+    h = bc_hash_int(h, has_kanji_rom);
+
+				/* ディスクイメージ */
+    for (i = 0; i < NR_DRIVE; i++) {
+	if (config_image.d[i]) {
+	    h = bc_hash_file(h, config_image.d[i]);
+	}
+	h = bc_hash_int(h, config_image.n[i]);
+	h = bc_hash_int(h, config_image.ro[i]);
+    }
+
+				/* 起動時の設定 (quasi88_reset で反映する分) */
+    h = bc_hash_int(h, boot_basic);
+    h = bc_hash_int(h, boot_dipsw);
+    h = bc_hash_int(h, boot_from_rom);
+    h = bc_hash_int(h, boot_clock_4mhz);
+    h = bc_hash_int(h, set_version);
+    h = bc_hash_int(h, baudrate_sw);
+    h = bc_hash_int(h, use_extram);
+    h = bc_hash_int(h, use_jisho_rom);
+    h = bc_hash_int(h, use_pcg);
+    h = bc_hash_int(h, sound_board);
+
+				/* 保存する時点 */
+    h = bc_hash_int(h, bootcache_frame);
+    h = bc_hash_int(h, bootcache_pc);
+
+    return h;
+}
+
+
+
+/*----------------------------------------------------------------------
+ * 起動時 (メモリ確保・ROMロードの後) に呼び出す。
+ *	キャッシュがあればロードして真を返す。なければ作成の準備をする。
+ *----------------------------------------------------------------------*/
+int	bootcache_load(void)
+{
+    char name[32];
+    char save[ QUASI88_MAX_FILENAME ];
+    int  success;
+    T_RESET_CFG cfg;
+    T_BC_RUN_CFG run;
+
+    bc_state = BC_IDLE;
+
+    if (use_bootcache == FALSE) return FALSE;
+
+    sprintf(name, "boot-%08lx" STATE_SUFFIX, (unsigned long) bc_key());
+    if (osd_path_join(osd_dir_state(), name, bc_file, QUASI88_MAX_FILENAME)
+								== FALSE) {
+	return FALSE;
+    }
+
+    strcpy(save, filename_get_state());	/* 通常のステートファイル名は保持 */
+    filename_set_state(bc_file);
+
+    success = FALSE;
+    if (stateload_check_file_exist()) {
+
+	quasi88_get_reset_cfg(&cfg);	/* 途中で失敗した時のために保持 */
+	run.cpu_timing      = cpu_timing;
+	run.select_main_cpu = select_main_cpu;
+	run.dual_cpu_count  = dual_cpu_count;
+	run.cpu_1_count     = CPU_1_COUNT;
+	run.cpu_slice_us    = cpu_slice_us;
+	run.cpu_clock_mhz   = cpu_clock_mhz;
+	run.sound_clock_mhz = sound_clock_mhz;
+	run.vsync_freq_hz   = vsync_freq_hz;
+	run.wait_rate       = wait_rate;
+	run.no_wait         = no_wait;
+
+	if (verbose_proc) printf("Boot cache %s ...", bc_file);
+	success = stateload();
+	if (verbose_proc) printf("%s\n", (success) ? "OK" : "FAILED");
+
+					/* 実行時の設定は、起動時の指定に戻す */
+	cpu_timing      = run.cpu_timing;
+	select_main_cpu = run.select_main_cpu;
+	dual_cpu_count  = run.dual_cpu_count;
+	CPU_1_COUNT     = run.cpu_1_count;
+	cpu_slice_us    = run.cpu_slice_us;
+	wait_rate       = run.wait_rate;
+	no_wait         = run.no_wait;
+	if (cpu_clock_mhz   != run.cpu_clock_mhz   ||
+	    sound_clock_mhz != run.sound_clock_mhz ||
+	    vsync_freq_hz   != run.vsync_freq_hz) {
+	    cpu_clock_mhz   = run.cpu_clock_mhz;
+	    sound_clock_mhz = run.sound_clock_mhz;
+	    vsync_freq_hz   = run.vsync_freq_hz;
+	    if (success) {		/* 割り込みの周期を、クロックに合わせる */
+		interval_work_init_all();
+	    }
+	}
+
+	if (success == FALSE) {		/* 設定を戻し、キャッシュは削除 */
+	    boot_basic      = cfg.boot_basic;
+	    boot_dipsw      = cfg.boot_dipsw;
+	    boot_from_rom   = cfg.boot_from_rom;
+	    boot_clock_4mhz = cfg.boot_clock_4mhz;
+	    set_version     = cfg.set_version;
+	    baudrate_sw     = cfg.baudrate_sw;
+	    use_extram      = cfg.use_extram;
+	    use_jisho_rom   = cfg.use_jisho_rom;
+	    sound_board     = cfg.sound_board;
+
+	    if (memory_allocate_additional() == FALSE) {
+		quasi88_exit(-1);
+	    }
+	    remove(bc_file);
+	}
+    }
+
+    filename_set_state(save);
+
+    if (success == FALSE) {		/* ないので、作成する */
+	bc_state  = BC_WAIT;
+	bc_frames = 0;
+	if (verbose_proc) printf("Boot cache %s will be created\n", bc_file);
+    }
+    return success;
+}
+
+
+
+/*----------------------------------------------------------------------
+ * 1フレーム毎に呼び出す。保存する時点に達したら、ステートセーブする
+ *----------------------------------------------------------------------*/
+void	bootcache_update(void)
+{
+    char save[ QUASI88_MAX_FILENAME ];
+    int  success;
+
+    if (bc_state == BC_IDLE) return;
+
+    bc_frames ++;
+    if (bootcache_pc < 0 && bc_frames >= bootcache_frame) {
+	bc_state = BC_REACH;
+    }
+    if (bc_state != BC_REACH) return;
+
+    strcpy(save, filename_get_state());
+    filename_set_state(bc_file);
+    success = statesave();
+    filename_set_state(save);
+
+    if (verbose_proc) {
+	printf("Boot cache %s ...%s\n", bc_file, (success) ? "saved" : "FAILED");
+    }
+
+    bc_state = BC_IDLE;
+
+    /* PC のチェックを止めるため、モード変更扱いとして emu_init() させる */
+    if (bootcache_pc >= 0) {
+	quasi88_event_flags |= EVENT_MODE_CHANGED;
+    }
+}
+
+
+
+/*----------------------------------------------------------------------
+ * リセットやステートロードなどで、起動時の状態が崩れたら呼び出す
+ *----------------------------------------------------------------------*/
+void	bootcache_cancel(void)
+{
+    if (bc_state != BC_IDLE && verbose_proc) {
+	printf("Boot cache canceled\n");
+    }
+    bc_state = BC_IDLE;
+}
+
+
+
+/*----------------------------------------------------------------------
+ * PC を指定している場合、その PC に達するのを待っているなら真を返す。
+ *	真の間は、メインCPU の 1ステップ毎に bootcache_check_pc() を呼ぶこと
+ *----------------------------------------------------------------------*/
+int	bootcache_wait_pc(void)
+{
+    return (bc_state == BC_WAIT && bootcache_pc >= 0);
+}
+
+void	bootcache_check_pc(word pc)
+{
+    if (bc_state == BC_WAIT && pc == (word) bootcache_pc) {
+	bc_state = BC_REACH;
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef BOOTCACHE_H_INCLUDED
+#define BOOTCACHE_H_INCLUDED
+
+
+/*----------------------------------------------------------------------
+ * ֡ȥå
+ *	Ÿ顢ꤷե졼 (뤤ϻꤷɥ쥹
+ *	ᥤCPU  PC ã) ޤǤ¹Ԥ顢ơȥ֤롣
+ *	ʹߤεưǤϡΥơȥեɤơư
+ *	ά롣
+ *
+ *	ơȥե̾ˤϡROM᡼ǥ᡼Ƥ
+ *	ư꤫᤿ϥåͤޤΤǡ餬Ѥ
+ *	ưṲ̄ΥåȤʤ롣
+ *----------------------------------------------------------------------*/
+
+extern	int	use_bootcache;		/* ʤ֡ȥåȤ	*/
+extern	int	bootcache_frame;	/* ¸ޤǤΥե졼	*/
+extern	int	bootcache_pc;		/* ¸ PC (ʤ̤)	*/
+
+int	bootcache_load(void);
+void	bootcache_update(void);
+void	bootcache_cancel(void);
+
+int	bootcache_wait_pc(void);
+void	bootcache_check_pc(word pc);
+
+
+#endif	/* BOOTCACHE_H_INCLUDED */
@@ -0,0 +1,371 @@
+/************************************************************************/
+/*									*/
+/* ディスクイメージのカタログ (イメージ一覧のキャッシュ)		*/
+/*									*/
+/************************************************************************/
+
+/*
+  ○概要
+	disk_insert() では、ディスクイメージファイル内の全イメージのヘッダを
+	先頭から順に読んで、イメージの一覧を作る。イメージ数の多いファイル
+	や、ネットワーク越しのファイルでは、これに時間がかかる。
+	-diskcat を指定すると、この一覧をファイル名・ファイルサイズ・更新
+	時刻とともに記録しておき、次回からはヘッダを読まずに一覧を得る。
+
+  ○記録の無効化
+	ファイルサイズか更新時刻が変わっていれば、記録は使わずに読み直す。
+	ただし、更新時刻は秒単位なので、更新直後 (DISKCAT_RACY 秒以内) の
+	ファイルは、同じ時刻のまま再度更新されるかもしれないので記録しない。
+	-diskjournal / -diskoverlay 指定時は、書き込みがすぐにはファイルに
+	反映されないので、カタログは使わない。
+
+  ○保存
+	終了時に、設定ディレクトリの diskcat.idx に保存し (変更があれば)、
+	起動時に読み込む。1行目は識別子、以降は以下の形式のテキスト。
+		F <サイズ> <更新時刻> <イメージ数> <多過ぎ> <破損> <ファイル名>
+		I <プロテクト> <タイプ> <サイズ> <イメージ名 (16進数32桁)>
+	F 行の後に、イメージ数だけ I 行が続く。区切りはタブ。
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "quasi88.h"
+#include "diskcat.h"
+#include "file-op.h"
+
+
+int	use_diskcat = FALSE;		/* 真ならカタログを使う		*/
+
+
+#define	DISKCAT_FILE	"diskcat.idx"	/* 保存するファイル名		*/
+#define	DISKCAT_ID	"QUASI88 DISKCAT 1"
+#define	DISKCAT_MAX	(8192)		/* 記録するファイルの最大数	*/
+#define	DISKCAT_RACY	(2)		/* 更新直後とみなす秒数		*/
+
+typedef	struct {
+    char	name[17];		/* イメージ名			*/
+    char	protect;		/* プロテクト			*/
+    char	type;			/* ディスクタイプ		*/
+    long	size;			/* サイズ			*/
+} T_CAT_IMAGE;
+
+typedef	struct {
+    char	*filename;		/* ファイル名 (NULL なら未使用)	*/
+    bit32	hash;			/* ファイル名のハッシュ値	*/
+    long	size;			/* ファイルサイズ		*/
+    long	mtime;			/* 更新時刻			*/
+    char	over_image;		/* イメージ数が多過ぎるなら真	*/
+    char	detect_broken_image;	/* 壊れたイメージがあれば真	*/
+    int		image_nr;		/* イメージ数			*/
+    T_CAT_IMAGE	*image;			/* イメージ情報 [image_nr]	*/
+} T_CAT_ENTRY;
+
+static	T_CAT_ENTRY	*cat_entry;	/* 記録 [DISKCAT_MAX]		*/
+static	int		cat_nr;		/* 記録の数			*/
+static	int		cat_victim;	/* 満杯時に、次に上書きする位置	*/
+static	int		cat_dirty;	/* 真なら、終了時に保存する	*/
+
+
+
+/*----------------------------------------------------------------------
+ * 記録の検索・登録
+ *----------------------------------------------------------------------*/
+static	bit32	cat_hash(const char *filename)
+{
+    bit32 h = 2166136261u;
+
+    while (*filename) {			/* FNV-1a (32bit) */
+	h ^= (byte) *filename++;
+	h *= 16777619u;
+    }
+    return h;
+}
+
+static	T_CAT_ENTRY	*cat_search(const char *filename)
+{
+    bit32 h = cat_hash(filename);
+    int   i;
+
+    for (i = 0; i < cat_nr; i++) {
+	if (cat_entry[i].hash == h &&
+	    strcmp(cat_entry[i].filename, filename) == 0) {
+	    return &cat_entry[i];
+	}
+    }
+    return NULL;
+}
+
+static	void	cat_free(T_CAT_ENTRY *e)
+{
+    free(e->filename);
+    free(e->image);
+    e->filename = NULL;
+    e->image    = NULL;
+}
+
+/* filename の記録を (なければ新たに) 確保し、イメージ数分のワークを用意 */
+static	T_CAT_ENTRY	*cat_alloc(const char *filename, int image_nr)
+{
+    T_CAT_ENTRY *e = cat_search(filename);
+
+    if (e == NULL) {
+	if (cat_nr < DISKCAT_MAX) {
+	    e = &cat_entry[ cat_nr ++ ];
+	} else {			/* 満杯なら、順に上書きしていく */
+	    e = &cat_entry[ cat_victim ];
+	    cat_victim = (cat_victim + 1) % DISKCAT_MAX;
+	    cat_free(e);
+	}
+	e->filename = (char *)malloc(strlen(filename) + 1);
+	if (e->filename == NULL) {
+	    *e = cat_entry[ -- cat_nr ];
+	    return NULL;
+	}
+	strcpy(e->filename, filename);
+	e->hash = cat_hash(filename);
+    } else {
+	free(e->image);
+    }
+
+    e->image_nr = image_nr;
+    e->image    = (T_CAT_IMAGE *)malloc(sizeof(T_CAT_IMAGE) * image_nr);
+    if (e->image == NULL) {
+	e->image_nr = 0;		/* 記録は残るが、一致しなくなる */
+	e->size     = -1;
+	return NULL;
+    }
+    return e;
+}
+
+
+
+/*----------------------------------------------------------------------
+ * カタログが使えるか (ファイルの状態も取得する)
+ *----------------------------------------------------------------------*/
+static	int	cat_usable(const char *filename, long *size, long *mtime)
+{
+    if (cat_entry == NULL) return FALSE;
+    if (disk_journal || dir_disk_overlay) return FALSE;
+
+    if (strchr(filename, '\t') || strchr(filename, '\n')) return FALSE;
+
+    return osd_file_stamp(filename, size, mtime);
+}
+
+
+
+/*----------------------------------------------------------------------
+ * ディスク挿入時に呼び出す。記録があれば、イメージの一覧を drv にセット
+ *	して真を返す。なければ偽を返す (呼び出し側で、ヘッダを読むこと)
+ *----------------------------------------------------------------------*/
+int	diskcat_load(const char *filename, PC88_DRIVE_T *drv)
+{
+    T_CAT_ENTRY *e;
+    long size, mtime;
+    int  i;
+
+    if (cat_usable(filename, &size, &mtime) == FALSE) return FALSE;
+
+    e = cat_search(filename);
+    if (e == NULL || e->image_nr == 0 ||
+	e->size != size || e->mtime != mtime) {
+	return FALSE;
+    }
+
+    drv->over_image          = e->over_image;
+    drv->detect_broken_image = e->detect_broken_image;
+    drv->image_nr            = e->image_nr;
+    for (i = 0; i < e->image_nr; i++) {
+	memcpy(drv->image[i].name, e->image[i].name, 17);
+	drv->image[i].protect = e->image[i].protect;
+	drv->image[i].type    = e->image[i].type;
+	drv->image[i].size    = e->image[i].size;
+    }
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------
+ * ディスク挿入時、ヘッダを読んでイメージの一覧を作ったら呼び出す
+ *----------------------------------------------------------------------*/
+void	diskcat_store(const char *filename, const PC88_DRIVE_T *drv)
+{
+    T_CAT_ENTRY *e;
+    long size, mtime;
+    int  i;
+
+    if (drv->image_nr <= 0) return;
+    if (cat_usable(filename, &size, &mtime) == FALSE) return;
+
+    /* 更新直後なら、同じ時刻のまま更新されるかもしれないので、記録しない */
+    if ((long) time(NULL) - mtime <= DISKCAT_RACY) return;
+
+    if ((e = cat_alloc(filename, drv->image_nr)) == NULL) return;
+
+    e->size                = size;
+    e->mtime               = mtime;
+    e->over_image          = drv->over_image;
+    e->detect_broken_image = drv->detect_broken_image;
+    for (i = 0; i < drv->image_nr; i++) {
+	memcpy(e->image[i].name, drv->image[i].name, 17);
+	e->image[i].protect = drv->image[i].protect;
+	e->image[i].type    = drv->image[i].type;
+	e->image[i].size    = drv->image[i].size;
+    }
+    cat_dirty = TRUE;
+}
+
+
+
+/*----------------------------------------------------------------------
+ * カタログファイルの読み書き
+ *----------------------------------------------------------------------*/
+static	int	cat_path(char path[])
+{
+    const char *dir = osd_dir_gcfg();
+
+    if (dir == NULL) return FALSE;
+    return osd_path_join(dir, DISKCAT_FILE, path, QUASI88_MAX_FILENAME);
+}
+
+static	void	cat_read(FILE *fp)
+{
+    char line[ QUASI88_MAX_FILENAME + 64 ];
+    char *name, *p;
+    long size, mtime, isize;
+    int  image_nr, over, broken, protect, type;
+    int  i, j, c;
+    T_CAT_ENTRY *e;
+
+    if (fgets(line, sizeof(line), fp) == NULL ||
+	strncmp(line, DISKCAT_ID, strlen(DISKCAT_ID)) != 0) {
+	return;					/* 形式が違う */
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+
+	if ((p = strchr(line, '\n'))) *p = '\0';
+
+	if (sscanf(line, "F\t%ld\t%ld\t%d\t%d\t%d\t",
+		   &size, &mtime, &image_nr, &over, &broken) != 5 ||
+	    image_nr <= 0 || image_nr > MAX_NR_IMAGE) {
+	    return;				/* 壊れている */
+	}
+	name = line;				/* 7番目の項目がファイル名 */
+	for (i = 0; i < 6 && name; i++) {
+	    if ((name = strchr(name, '\t'))) name ++;
+	}
+	if (name == NULL || *name == '\0') return;
+
+	if ((e = cat_alloc(name, image_nr)) == NULL) return;
+	e->size                = size;
+	e->mtime               = mtime;
+	e->over_image          = over;
+	e->detect_broken_image = broken;
+
+	for (i = 0; i < image_nr; i++) {
+	    if (fgets(line, sizeof(line), fp) == NULL ||
+		sscanf(line, "I\t%x\t%x\t%ld\t", &protect, &type, &isize) != 3 ||
+		(p = strrchr(line, '\t')) == NULL) {
+		e->size = -1;			/* 不完全な記録は使わない */
+		return;
+	    }
+	    p ++;
+	    for (j = 0; j < 16; j++) {
+		if (sscanf(&p[j * 2], "%2x", &c) != 1) c = 0;
+		e->image[i].name[j] = c;
+	    }
+	    e->image[i].name[16] = '\0';
+	    e->image[i].protect  = protect;
+	    e->image[i].type     = type;
+	    e->image[i].size     = isize;
+	}
+    }
+}
+
+static	void	cat_write(FILE *fp)
+{
+    int i, j, k;
+    T_CAT_ENTRY *e;
+
+    fprintf(fp, "%s\n", DISKCAT_ID);
+
+    for (i = 0; i < cat_nr; i++) {
+	e = &cat_entry[i];
+	if (e->image_nr <= 0 || e->size < 0) continue;
+
+	fprintf(fp, "F\t%ld\t%ld\t%d\t%d\t%d\t%s\n",
+		e->size, e->mtime, e->image_nr,
+		e->over_image, e->detect_broken_image, e->filename);
+
+	for (j = 0; j < e->image_nr; j++) {
+	    fprintf(fp, "I\t%02x\t%02x\t%ld\t",
+		    (byte) e->image[j].protect, (byte) e->image[j].type,
+		    e->image[j].size);
+	    for (k = 0; k < 16; k++) {
+		fprintf(fp, "%02x", (byte) e->image[j].name[k]);
+	    }
+	    fprintf(fp, "\n");
+	}
+    }
+}
+
+
+
+/*----------------------------------------------------------------------
+ * 起動時 (イメージファイルを開く前) に呼び出す。カタログを読み込む
+ *----------------------------------------------------------------------*/
+void	diskcat_init(void)
+{
+    char path[ QUASI88_MAX_FILENAME ];
+    FILE *fp;
+
+    cat_nr     = 0;
+    cat_victim = 0;
+    cat_dirty  = FALSE;
+
+    if (use_diskcat == FALSE) return;
+
+    cat_entry = (T_CAT_ENTRY *)calloc(DISKCAT_MAX, sizeof(T_CAT_ENTRY));
+    if (cat_entry == NULL) {
+	printf("Disk catalog : memory allocate failed\n");
+	return;
+    }
+
+    if (cat_path(path) && (fp = fopen(path, "r"))) {
+	cat_read(fp);
+	fclose(fp);
+	if (verbose_proc) printf("Disk catalog %s ... %d files\n", path, cat_nr);
+    }
+}
+
+/*----------------------------------------------------------------------
+ * 終了時に呼び出す。変更があれば、カタログを保存する
+ *----------------------------------------------------------------------*/
+void	diskcat_exit(void)
+{
+    char path[ QUASI88_MAX_FILENAME ];
+    FILE *fp;
+    int  i;
+
+    if (cat_entry == NULL) return;
+
+    if (cat_dirty && cat_path(path)) {
+	if ((fp = fopen(path, "w"))) {
+	    cat_write(fp);
+	    fclose(fp);
+	    if (verbose_proc) printf("Disk catalog %s ... saved\n", path);
+	} else {
+	    if (verbose_proc) printf("Disk catalog %s ... FAILED\n", path);
+	}
+    }
+
+    for (i = 0; i < cat_nr; i++) {
+	cat_free(&cat_entry[i]);
+    }
+    free(cat_entry);
+    cat_entry = NULL;
+    cat_nr    = 0;
+}
@@ -0,0 +1,27 @@
+#ifndef DISKCAT_H_INCLUDED
+#define DISKCAT_H_INCLUDED
+
+#include "drive.h"
+
+
+/*----------------------------------------------------------------------
+ * ǥ᡼Υ
+ *	ǥ᡼ե᡼Υإå (᡼̾
+ *	ץƥȡס) 򡢥ե̾ե륵
+ *	ȤȤ˵ϿƤե뤬ѤäƤʤСǥ
+ *	ˡ᡼Υإåɤľ˺Ѥޤ롣
+ *
+ *	Ͽϡλǥ쥯ȥΥե¸εư
+ *	ɤ߹ࡣ
+ *----------------------------------------------------------------------*/
+
+extern	int	use_diskcat;		/* ʤ饫Ȥ		*/
+
+void	diskcat_init(void);
+void	diskcat_exit(void);
+
+int	diskcat_load(const char *filename, PC88_DRIVE_T *drv);
+void	diskcat_store(const char *filename, const PC88_DRIVE_T *drv);
+
+
+#endif	/* DISKCAT_H_INCLUDED */
@@ -46,6 +46,8 @@ typedef	struct{
   char	protect;		/* 饤ȥץƥ			*/
   char	type;			/* ǥ			*/
 
+  struct T_DISK_INDEX *index;	/* IDκ (NULLʤʤ)	*/
+
 				/* ե̾				*/
 
   /* char	filename[ QUASI88_MAX_FILENAME ];*/
@@ -106,6 +108,7 @@ int	disk_insert( int drv, const char *filename, int img, int readonly );
 int	disk_change_image( int drv, int img );
 void	disk_eject( int drv );
 int	disk_insert_A_to_B( int src, int dst, int img );
+void	disk_index_rebuild( OSD_FILE *fp );
 
 void	drive_set_empty( int drv );
 void	drive_unset_empty( int drv );
@@ -24,6 +24,7 @@
 #include "status.h"
 #include "graph.h"
 #include "snddrv.h"
+#include "bootcache.h"
 
 
 
@@ -126,6 +127,7 @@ static	int	check_break_point_PC( void )
 /*
  * CPU を 1step 実行して、PCがブレークポイントに達したかチェックする
  *	ブレークポイント(タイプPC)未設定ならこの関数は使わず、z80_emu()を使う
+ *	(ブートキャッシュの保存時点を PC で待っている間も、この関数を使う)
  */
 
 static	int	z80_emu_with_breakpoint( z80arch *z80, int unused )
@@ -134,8 +136,8 @@ static	int	z80_emu_with_breakpoint( z80arch *z80, int unused )
 
   states = z80_emu( z80, 1 );		/* 1step だけ実行 */
 
-  if( z80==&z80main_cpu ) cpu = BP_MAIN;
-  else                    cpu = BP_SUB;
+  if( z80==&z80main_cpu ){ cpu = BP_MAIN;  bootcache_check_pc( z80->PC.W ); }
+  else                     cpu = BP_SUB;
 
   for( i=0; i<NR_BP; i++ ){
     if( break_point[cpu][i].type == BP_PC     &&
@@ -184,7 +186,8 @@ void	emu_init(void)
 
 
 	/* ブレークポイント設定の有無で、呼び出す関数を変える */
-  if( check_break_point_PC() ) z80_exec = z80_emu_with_breakpoint;
+  if( check_break_point_PC() ||
+      bootcache_wait_pc() )    z80_exec = z80_emu_with_breakpoint;
   else                         z80_exec = z80_emu;
 
 
@@ -285,6 +288,12 @@ void	emu_main(void)
 	}
       }
 
+      /* サウンドの分割出力タイミングであれば、そこまでを出力 */
+      if (quasi88_event_flags & EVENT_AUDIO_PART) {
+	quasi88_event_flags &= ~EVENT_AUDIO_PART;
+	xmame_sound_part_update();
+      }
+
       /* サウンド出力タイミングであれば、処理 */
       if (quasi88_event_flags & EVENT_AUDIO_UPDATE) {
 	quasi88_event_flags &= ~EVENT_AUDIO_UPDATE;
@@ -342,6 +351,11 @@ void	emu_main(void)
 	}
       }
 
+      if (quasi88_event_flags & EVENT_AUDIO_PART) {
+	quasi88_event_flags &= ~EVENT_AUDIO_PART;
+	xmame_sound_part_update();
+      }
+
       if (quasi88_event_flags & EVENT_AUDIO_UPDATE) {
 	quasi88_event_flags &= ~EVENT_AUDIO_UPDATE;
 	profiler_lapse( PROF_LAPSE_SND );
@@ -22,6 +22,8 @@
 #include "status.h"
 #include "event.h"
 #include "snddrv.h"
+#include "stats.h"
+#include "diskcat.h"
 
 
 
@@ -521,6 +523,7 @@ int	disk_insert( int drv, const char *filename, int img, int readonly )
   Uchar c[32];
   long	offset;
   int	num;
+  int	cached;
 
   int	open_as_readonly = readonly;
 
@@ -604,6 +607,12 @@ int	disk_insert( int drv, const char *filename, int img, int readonly )
     num = 0;	offset = 0;
     exit_flag = FALSE;
 
+			/* カタログに記録があれば、ヘッダは読まない */
+    cached = diskcat_load( filename, &drive[ drv ] );
+    if( cached ){
+      num = drive[ drv ].image_nr;
+      exit_flag = TRUE;
+    }
 
 			/* 各イメージのヘッダ情報を全て取得 */
     while( !exit_flag ){
@@ -661,6 +670,8 @@ int	disk_insert( int drv, const char *filename, int img, int readonly )
 
     drive[ drv ].image_nr = num;
 
+    if( !cached ) diskcat_store( filename, &drive[ drv ] );
+
   }
 
 
@@ -726,6 +737,216 @@ int	disk_insert_A_to_B( int src, int dst, int img )
 
 
 
+/************************************************************************/
+/* ID情報の索引								*/
+/*	イメージを選択した時に、全トラックについて disk_next_sec() が	*/
+/*	たどる順に ID情報を読み込み、トラック毎の配列にしておく。	*/
+/*	disk_now_track() / disk_now_sec() は、索引があればそれを使い、	*/
+/*	ファイルの読み込み (シーク) を省略する。索引は ID情報のファイル	*/
+/*	位置で引くので、セクタの並びや回転位置の扱いは従来どおり。	*/
+/*									*/
+/*	読み込みに失敗したトラックは索引を作らず、従来どおりファイルから	*/
+/*	読む (エラー処理もそちらで行なう)。				*/
+/*	ID情報を書き換えた時は、disk_index_written() で索引を更新する。	*/
+/************************************************************************/
+#define	INDEX_TRACK	(164)
+
+typedef struct {
+  long	pos;				/* ID情報のファイル位置		*/
+  Uchar	id[ SZ_DISK_ID ];		/* ID情報			*/
+} T_SEC_INDEX;
+
+struct T_DISK_INDEX {
+  int		nr[ INDEX_TRACK ];	/* 索引のセクタ数 (-1:索引なし,	*/
+					/*        0:トラック位置が 0)	*/
+  T_SEC_INDEX	*sec[ INDEX_TRACK ];	/* セクタ毎の ID情報		*/
+  int		trk;			/* 現在のトラック (-1:索引なし)	*/
+  int		cur;			/* 現在のセクタの、索引の位置	*/
+};
+
+/* ファイル位置 pos から 16バイト読む。buf (ファイル位置 top から size
+   バイトの内容) の範囲内なら、そこからコピーする */
+static	int	index_read( int drv, long pos, Uchar *c, int len,
+			    const Uchar *buf, long top, long size )
+{
+  if( buf && pos >= top && pos + len <= top + size ){
+    memcpy( c, &buf[ pos - top ], len );
+    return TRUE;
+  }
+  if( osd_fseek( drive[ drv ].fp, pos, SEEK_SET )==0 &&
+      osd_fread( c, sizeof(Uchar), len, drive[ drv ].fp )==(size_t)len ){
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/* ミックスセクタ作成時に上書きされた ID の数 (disk_next_sec() と同じ) */
+static	int	index_overwrite_id( const Uchar *c )
+{
+  int size = c[DISK_SEC_SZ] + (int)c[DISK_SEC_SZ+1]*256;
+  int n;
+
+  if( size == 0x80 || (size & 0xff) == 0 ) return 0;
+
+  n = ( size - ( 128 << (c[DISK_N] & 7)) ) / SZ_DISK_ID;
+  return ( n < 0 ) ? 0 : n;
+}
+
+/* 1トラック分の索引を作る */
+static	void	index_build_track( int drv, int trk,
+				   const Uchar *buf, long top, long size )
+{
+  struct T_DISK_INDEX *idx = drive[ drv ].index;
+  T_SEC_INDEX *s;
+  Uchar c[ SZ_DISK_ID ];
+  long	pos;
+  int	sec_nr, sec, nr, sz;
+
+  free( idx->sec[ trk ] );
+  idx->sec[ trk ] = NULL;
+  idx->nr[ trk ]  = -1;
+
+  if( index_read( drv, drive[ drv ].disk_top + DISK_TRACK + trk*4, c, 4,
+		  buf, top, size )==FALSE ) return;
+
+  pos = (long)c[0]+((long)c[1]<<8)+((long)c[2]<<16)+((long)c[3]<<24);
+  if( pos==0 ){
+    idx->nr[ trk ] = 0;
+    return;
+  }
+  pos += drive[ drv ].disk_top;
+
+	/* 先頭セクタのセクタ数だけ確保し、disk_next_sec() と同じ順にたどる */
+
+  if( index_read( drv, pos, c, SZ_DISK_ID, buf, top, size )==FALSE ) return;
+  sec_nr = c[DISK_SEC_NR] + (int)c[DISK_SEC_NR+1]*256;
+
+  s = (T_SEC_INDEX *)malloc( sizeof(T_SEC_INDEX) * ((sec_nr>0) ? sec_nr : 1) );
+  if( s==NULL ) return;
+
+  nr  = 0;
+  sec = 0;
+  for( ;; ){
+    s[ nr ].pos = pos;
+    if( index_read( drv, pos, s[ nr ].id, SZ_DISK_ID,
+		    buf, top, size )==FALSE ){
+      free( s );
+      return;
+    }
+    sz = s[ nr ].id[DISK_SEC_SZ] + (int)s[ nr ].id[DISK_SEC_SZ+1]*256;
+    sec += 1 + index_overwrite_id( s[ nr ].id );
+    nr ++;
+
+    if( sec >= sec_nr ) break;
+    pos += sz + SZ_DISK_ID;
+  }
+
+  idx->sec[ trk ] = s;
+  idx->nr[ trk ]  = nr;
+}
+
+static	void	index_free( int drv )
+{
+  int	trk;
+
+  if( drive[ drv ].index ){
+    for( trk=0; trk<INDEX_TRACK; trk++ ){
+      free( drive[ drv ].index->sec[ trk ] );
+    }
+    free( drive[ drv ].index );
+    drive[ drv ].index = NULL;
+  }
+}
+
+/* 選択中のイメージの索引を作る。イメージ全体を一度に読めればそこから、
+   読めなければ 1つずつファイルから読む */
+static	void	index_build( int drv )
+{
+  Uchar	*buf;
+  long	top  = drive[ drv ].disk_top;
+  long	size = drive[ drv ].disk_end - drive[ drv ].disk_top;
+  int	trk;
+
+  index_free( drv );
+
+  drive[ drv ].index =
+	(struct T_DISK_INDEX *)calloc( 1, sizeof(struct T_DISK_INDEX) );
+  if( drive[ drv ].index==NULL ) return;
+
+  buf = (size > 0) ? (Uchar *)malloc( size ) : NULL;
+  if( buf ){
+    if( osd_fseek( drive[ drv ].fp, top, SEEK_SET )!=0 ||
+	osd_fread( buf, sizeof(Uchar), size, drive[ drv ].fp )!=(size_t)size ){
+      free( buf );
+      buf = NULL;
+    }
+  }
+
+  for( trk=0; trk<INDEX_TRACK; trk++ ){
+    index_build_track( drv, trk, buf, top, size );
+  }
+  drive[ drv ].index->trk = drive[ drv ].track;
+
+  free( buf );
+}
+
+/* ファイル位置 from〜to を書き換えた後に呼ぶ。
+   同じファイルを開いている全ドライブについて、ID情報が重なるセクタの
+   索引を読み直す。セクタの並びに関わる値 (セクタ数・サイズ・N) が
+   変わったら、そのトラックは作り直す */
+static	void	disk_index_written( int drv, long from, long to )
+{
+  struct T_DISK_INDEX *idx;
+  T_SEC_INDEX *s;
+  Uchar	c[ SZ_DISK_ID ];
+  int	d, trk, i, rebuild;
+
+  for( d=0; d<NR_DRIVE; d++ ){
+    if( drive[ d ].fp != drive[ drv ].fp ||
+	(idx = drive[ d ].index)==NULL ) continue;
+
+    for( trk=0; trk<INDEX_TRACK; trk++ ){
+      rebuild = FALSE;
+      for( i=0; i<idx->nr[ trk ]; i++ ){
+	s = &idx->sec[ trk ][ i ];
+	if( s->pos + SZ_DISK_ID <= from || s->pos >= to ) continue;
+
+	if( index_read( d, s->pos, c, SZ_DISK_ID, NULL, 0, 0 )==FALSE ){
+	  rebuild = TRUE;
+	  break;
+	}
+	if( (i==0 &&
+	     memcmp( &c[DISK_SEC_NR], &s->id[DISK_SEC_NR], 2 )!=0) ||
+	    memcmp( &c[DISK_SEC_SZ], &s->id[DISK_SEC_SZ], 2 )!=0  ||
+	    c[DISK_N] != s->id[DISK_N] ){
+	  rebuild = TRUE;
+	  break;
+	}
+	memcpy( s->id, c, SZ_DISK_ID );
+      }
+      if( rebuild ){
+	index_build_track( d, trk, NULL, 0, 0 );
+	if( idx->trk == trk ) idx->cur = 0;
+      }
+    }
+  }
+}
+
+/* イメージファイルを外部 (メニューなど) で書き換えた後に呼ぶ。
+   そのファイルを開いている全ドライブの索引を作り直す */
+void	disk_index_rebuild( OSD_FILE *fp )
+{
+  int	drv;
+
+  for( drv=0; drv<NR_DRIVE; drv++ ){
+    if( fp && drive[ drv ].fp == fp && drive[ drv ].index ){
+      index_build( drv );
+    }
+  }
+}
+
+
+
 /************************************************************************/
 /* イメージを変更する。							*/
 /*	disk_top をimg 枚目のディスクイメージの先頭に設定し、		*/
@@ -775,8 +996,9 @@ int	disk_change_image( int drv, int img )
     ;
   }
 
-		/* pcn*2 トラックの先頭に移動する */
+		/* ID情報の索引を作り、pcn*2 トラックの先頭に移動する */
 
+  index_build( drv );
   disk_now_track( drv, fdc.pcn[drv]*2 );
 
   if (disk_exchange) disk_ex_drv |= 1 << drv;	/* ディスク入れ替えたよん */
@@ -799,6 +1021,7 @@ void	disk_eject( int drv )
       osd_fclose( drive[ drv ].fp );
     }
   }
+  index_free( drv );
   drive[ drv ].fp = NULL;
   drive[ drv ].sec_nr = -1;
   drive[ drv ].empty  = TRUE;
@@ -823,6 +1046,7 @@ static	void	disk_now_track( int drv, int trk )
   int	error = 0;
   Uchar c[4];
   long	track_top;
+  struct T_DISK_INDEX *idx = drive[ drv ].index;
 
 
 
@@ -840,6 +1064,28 @@ static	void	disk_now_track( int drv, int trk )
   drive[ drv ].sec       = 0;
 
 
+	/* 索引があれば、ファイルは読まない */
+
+  if( idx ){
+    idx->trk = trk;
+    idx->cur = 0;
+    if( idx->nr[ trk ] > 0 ){
+      drive[ drv ].track_top =
+      drive[ drv ].sec_pos   = idx->sec[ trk ][ 0 ].pos;
+      drive[ drv ].sec_nr    = disk_now_sec( drv );
+      sec_buf.drv = drv;
+      return;
+    }
+    if( idx->nr[ trk ] == 0 ){
+      drive[ drv ].track_top =
+      drive[ drv ].sec_pos   = drive[ drv ].disk_top;
+      drive[ drv ].sec_nr    = -1;
+      sec_buf.drv = drv;
+      return;
+    }
+  }
+
+
 	/* トラックのインデックスで指定されたファイル位置を取得 */
 
   if( osd_fseek( drive[ drv ].fp,
@@ -888,28 +1134,42 @@ static	void	disk_now_track( int drv, int trk )
 /*	エラー時は、そのセクタのは ID CRC Error エラーに設定する。	*/
 /*	返り値は、そのセクタの、「セクタ数(DISK_SEC_NR)」の値		*/
 /*======================================================================*/
+static	void	sec_buf_set_id( const Uchar *c );
+
 static	int	disk_now_sec( int drv )
 {
   int	error = 0;
   Uchar	c[16];
+  struct T_DISK_INDEX *idx = drive[ drv ].index;
+  T_SEC_INDEX *s;
+  int	i, nr;
+
+	/* 索引があれば、ファイル位置 sec_pos の ID情報 を探す。	*/
+	/* 通常は、前回の次のセクタなので、すぐに見つかる		*/
+
+  if( idx && idx->trk >= 0 && (nr = idx->nr[ idx->trk ]) > 0 ){
+    s = idx->sec[ idx->trk ];
+    i = idx->cur;
+    if( s[ i ].pos != drive[ drv ].sec_pos ){
+      if( ++i >= nr ) i = 0;
+      if( s[ i ].pos != drive[ drv ].sec_pos ){
+	for( i=0; i<nr; i++ ){
+	  if( s[ i ].pos == drive[ drv ].sec_pos ) break;
+	}
+      }
+    }
+    if( i < nr ){
+      idx->cur = i;
+      sec_buf_set_id( s[ i ].id );
+      return ( sec_buf.sec_nr );
+    }
+  }
 
 	/* ファイル位置 sec_pos の ID情報 を読み、セクタ数を返す */
 
   if( osd_fseek( drive[ drv ].fp,  drive[ drv ].sec_pos,  SEEK_SET )==0 ){
     if( osd_fread( c, sizeof(Uchar), 16, drive[ drv ].fp )==16 ){
-      sec_buf.c       = c[DISK_C];
-      sec_buf.h       = c[DISK_H];
-      sec_buf.r       = c[DISK_R];
-      sec_buf.n       = c[DISK_N];
-      sec_buf.density = c[DISK_DENSITY];
-      sec_buf.deleted = c[DISK_DELETED];
-      sec_buf.status  = c[DISK_STATUS];
-      sec_buf.sec_nr  = c[DISK_SEC_NR] + (int)c[DISK_SEC_NR+1]*256;
-      sec_buf.size    = c[DISK_SEC_SZ] + (int)c[DISK_SEC_SZ+1]*256;
-      if( sec_buf.status==STATUS_CM ){
-	sec_buf.deleted = DISK_DELETED_TRUE;
-	sec_buf.status  = STATUS_NORMAL;
-      }
+      sec_buf_set_id( c );
     }
     else error = 1;
   } else error = 2;
@@ -931,6 +1191,23 @@ static	int	disk_now_sec( int drv )
   return ( sec_buf.sec_nr );
 }
 
+static	void	sec_buf_set_id( const Uchar *c )
+{
+  sec_buf.c       = c[DISK_C];
+  sec_buf.h       = c[DISK_H];
+  sec_buf.r       = c[DISK_R];
+  sec_buf.n       = c[DISK_N];
+  sec_buf.density = c[DISK_DENSITY];
+  sec_buf.deleted = c[DISK_DELETED];
+  sec_buf.status  = c[DISK_STATUS];
+  sec_buf.sec_nr  = c[DISK_SEC_NR] + (int)c[DISK_SEC_NR+1]*256;
+  sec_buf.size    = c[DISK_SEC_SZ] + (int)c[DISK_SEC_SZ+1]*256;
+  if( sec_buf.status==STATUS_CM ){
+    sec_buf.deleted = DISK_DELETED_TRUE;
+    sec_buf.status  = STATUS_NORMAL;
+  }
+}
+
 
 
 /*======================================================================*/
@@ -1411,6 +1688,7 @@ static	int	fdc_read_data( void )
   int	drv = (fdc.us);
   int	read_size, size, ptr, error;
 
+  STATS_INC( STATS_FDC_READ );
 
   print_fdc_status(( (fdc.command==READ_DIAGNOSTIC) ? BP_DIAG : BP_READ ),
 		   drv, drive[drv].track, drive[drv].sec);
@@ -1557,6 +1835,8 @@ static	int	fdc_write_data( void )
   int	gap4_size  = sec_buf.size;
   int	gap4_wrote = FALSE;
 
+  STATS_INC( STATS_FDC_WRITE );
+
   print_fdc_status(BP_WRITE, drv, drive[drv].track, drive[drv].sec);
 
 
@@ -1715,6 +1995,8 @@ static	int	fdc_write_data( void )
 
   osd_fflush( drive[ drv ].fp );
 
+  disk_index_written( drv, id_pos, write_pos );	/* 索引を更新 */
+
 
 	/* 途中、システムのエラーが起こったら異常終了する */
 
@@ -1908,6 +2190,9 @@ static	int	fdc_write_id( void )
 
   osd_fflush( drive[ drv ].fp );
 
+  disk_index_written( drv, drive[ drv ].track_top,	/* 索引を更新 */
+		      format_pos + SZ_DISK_ID );
+
 
 	/* 途中、システムのエラーが起こったら異常終了する */
 
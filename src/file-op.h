@@ -59,6 +59,12 @@ void	osd_file_config_exit(void);
  *	int readonly_disk[2]
  *		ʤ顢꡼ɥ꡼ǥǥ᡼ե򳫤
  *
+ *	int disk_journal / char *dir_disk_overlay
+ *		ǥ᡼ؤν񤭹ߤ򡢥㡼ʥͳǹԤɤ
+ *		dir_disk_overlay  NULL ǤʤСΥ᡼Ϲ
+ *		ʬ򤽤Υǥ쥯ȥ¸롣
+ *		(¸бƤʤС̵뤷Ƥޤʤ)
+ *
  *	char *file_compatrom
  *		Υե P88SR.exe  ROM᡼եȤƳ
  *		NULL ξ̤̾ ROM᡼ե򳫤
@@ -97,6 +103,8 @@ void	osd_file_config_exit(void);
 extern char file_disk[2][QUASI88_MAX_FILENAME];	/*ǥ᡼ե̾*/
 extern int  image_disk[2];	   		/*᡼ֹ031,-1ϼư*/
 extern int  readonly_disk[2];			/*꡼ɥ꡼ǳʤ鿿*/
+extern int  disk_journal;			/*򥸥㡼ʥͳˤ*/
+extern char *dir_disk_overlay;			/*ʬ㡼ʥ¸    */
 
 extern char file_tape[2][QUASI88_MAX_FILENAME];	/* ơϤΥե̾ */
 extern char file_prn[QUASI88_MAX_FILENAME];	/* ѥϤΥե̾ */
@@ -304,6 +312,50 @@ int	osd_file_stat(const char *filename);
 
 
 
+/****************************************************************************
+ * եΥޥå
+ *
+ * void	*osd_file_map(const char *filename, size_t *size)
+ *	filename ΥեΤɤ߽ФѤǥ˥ޥåפ롣
+ *	ϥޥåפɥ쥹֤*size ˥ե륵򥻥åȤ롣
+ *	ޥåפǤʤ䡢εǽ̵ NULL ֤
+ *	(NULL ξ硢ƤӽФ¦̾Υեɤ߹ߤѤ)
+ *
+ * void	osd_file_unmap(void *addr, size_t size)
+ *	osd_file_map() ǥޥåפΰ롣
+ *****************************************************************************/
+void	*osd_file_map(const char *filename, size_t *size);
+void	osd_file_unmap(void *addr, size_t size);
+
+
+
+/****************************************************************************
+ * եΥȹμ
+ *
+ * int	osd_file_stamp(const char *filename, long *size, long *mtime)
+ *	filename ̾եΥ *size ˡ (ñ̤̤
+ *	ֹ档ñ̤äǤСϵ¸Ǥ褤)  *mtime ˥åȤ
+ *	֤ե뤬̵䡢εǽ̵ϵ֤
+ *	(ξ硢ƤӽФ¦ϵϿեȤʤ)
+ *****************************************************************************/
+int	osd_file_stamp(const char *filename, long *size, long *mtime);
+
+
+
+/****************************************************************************
+ * ե֤
+ *
+ * int	osd_file_replace(const char *tmpname, const char *filename)
+ *	񤭽Ĥե tmpname filename ֤롣
+ *	ǽʤ顢tmpname Ƥǥ˽񤭽ФƤ֤Τǡ
+ *	ǰ۾ｪλƤ⡢filename ϸŤΤɤ餫ˤʤ롣
+ *	ޤfilename ޥåפƤ¾ΥץϡŤƤΤޤ
+ *	ȤǤ롣Ͽ򡢼Ի tmpname Ƶ֤
+ *****************************************************************************/
+int	osd_file_replace(const char *tmpname, const char *filename);
+
+
+
 /****************************************************************************
  * ǥ쥯ȥ
  *
@@ -249,6 +249,15 @@ inline void StoreSample(Sample& dest, ISample data)
 		dest += data;
 }
 
+//	ISample ˲ä (åԥ󥰤 StoreSample Ʊ)
+inline void StoreISample(ISample& dest, ISample data)
+{
+	if (sizeof(Sample) == 2)
+		dest = Limit(dest + data, 0x7fff, -0x8000);
+	else
+		dest += data;
+}
+
 
 // ---------------------------------------------------------------------------
 //	AM Υ٥
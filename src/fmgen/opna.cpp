@@ -49,6 +49,41 @@ uint32	OPNBase::lfotable[8];			// OPNA/B 
 OPNBase::OPNBase()
 {
 	prescale = 0;
+	mixbuf = 0;
+	mixbufsize = 0;
+}
+
+OPNBase::~OPNBase()
+{
+	delete[] mixbuf;
+}
+
+//	L, R, L, R... ι (forQUASI88)
+//	Ʋ L/R ̡˹Τǡö mixbuf Ÿơ
+//	˵ͤľ
+ISample* OPNBase::LoadInterleaved(const Sample* buffer, int nsamples)
+{
+	if (mixbufsize < nsamples)
+	{
+		delete[] mixbuf;
+		mixbuf = new ISample[nsamples * 2];
+		mixbufsize = nsamples;
+	}
+	for (int i=0; i<nsamples; i++)
+	{
+		mixbuf[i]            = buffer[i*2+0];
+		mixbuf[nsamples + i] = buffer[i*2+1];
+	}
+	return mixbuf;
+}
+
+void OPNBase::StoreInterleaved(Sample* buffer, int nsamples)
+{
+	for (int i=0; i<nsamples; i++)
+	{
+		buffer[i*2+0] = (Sample) mixbuf[i];
+		buffer[i*2+1] = (Sample) mixbuf[nsamples + i];
+	}
 }
 
 //	ѥ᡼å
@@ -336,10 +371,17 @@ void OPN::SetChannelMask(uint mask)
 
 //	(2ch)
 void OPN::Mix(Sample* buffer, int nsamples)
+{
+	ISample* dest = LoadInterleaved(buffer, nsamples);
+	Mix(dest, dest + nsamples, nsamples);
+	StoreInterleaved(buffer, nsamples);
+}
+
+void OPN::Mix(ISample* destl, ISample* destr, int nsamples)
 {
 #define IStoSample(s)	((Limit(s, 0x7fff, -0x8000) * fmvolume) >> 14)
 	
-	psg.Mix(buffer, nsamples);
+	psg.Mix(destl, destr, nsamples);
 	
 	// Set F-Number
 	ch[0].SetFNum(fnum[0]);
@@ -357,16 +399,15 @@ void OPN::Mix(Sample* buffer, int nsamples)
 	int actch = (((ch[2].Prepare() << 2) | ch[1].Prepare()) << 2) | ch[0].Prepare();
 	if (actch & 0x15)
 	{
-		Sample* limit = buffer + nsamples * 2;
-		for (Sample* dest = buffer; dest < limit; dest+=2)
+		for (int i=0; i<nsamples; i++)
 		{
 			ISample s = 0;
 			if (actch & 0x01) s  = ch[0].Calc();
 			if (actch & 0x04) s += ch[1].Calc();
 			if (actch & 0x10) s += ch[2].Calc();
 			s = IStoSample(s);
-			StoreSample(dest[0], s);
-			StoreSample(dest[1], s);
+			StoreISample(destl[i], s);
+			StoreISample(destr[i], s);
 		}
 	}
 #undef IStoSample
@@ -396,6 +437,10 @@ OPNABase::OPNABase()
 	adpcmvol = 0;
 	control2 = 0;
 
+	memset(adpcmcache, 0, sizeof(adpcmcache));
+	adpcache = 0;
+	adpcachestamp = 0;
+
 	MakeTable2();
 	BuildLFOTable();
 	for (int i=0; i<6; i++)
@@ -407,6 +452,11 @@ OPNABase::OPNABase()
 
 OPNABase::~OPNABase()
 {
+	for (int i=0; i<adpcmcachenr; i++)
+	{
+		delete[] adpcmcache[i].x;
+		delete[] adpcmcache[i].d;
+	}
 }
 
 // ---------------------------------------------------------------------------
@@ -466,6 +516,7 @@ void OPNABase::Reset()
 	adpcmx = 0;
 	lfocount = 0;
 	adpcmplay = false;
+	adpcache = 0;
 	adplc = 0;
 	adpld = 0x100;
 	status = 0;
@@ -625,6 +676,7 @@ void OPNABase::SetADPCMBReg(uint addr, uint data)
 			memaddr = startaddr;
 			adpcmx = 0, adpcmd = 127;
 			adplc = 0;
+			SelectADPCMCache();
 		}
 		if (data & 1)
 		{
@@ -636,6 +688,7 @@ void OPNABase::SetADPCMBReg(uint addr, uint data)
 	case 0x01:		// Control Register 2
 		control2 = data;
 		granuality = control2 & 2 ? 1 : 4;
+		adpcache = 0;
 		break;
 
 	case 0x02:		// Start Address L
@@ -643,6 +696,7 @@ void OPNABase::SetADPCMBReg(uint addr, uint data)
 		adpcmreg[addr - 0x02 + 0] = data;
 		startaddr = (adpcmreg[1]*256+adpcmreg[0]) << 6;
 		memaddr = startaddr;
+		adpcache = 0;
 //		LOG1("  startaddr %.6x", startaddr);
 		break;
 
@@ -650,6 +704,7 @@ void OPNABase::SetADPCMBReg(uint addr, uint data)
 	case 0x05:		// Stop Address H
 		adpcmreg[addr - 0x04 + 2] = data;
 		stopaddr = (adpcmreg[3]*256+adpcmreg[2] + 1) << 6;
+		adpcache = 0;
 //		LOG1("  stopaddr %.6x", stopaddr);
 		break;
 
@@ -678,6 +733,7 @@ void OPNABase::SetADPCMBReg(uint addr, uint data)
 	case 0x0d:		// Limit Address H
 		adpcmreg[addr - 0x0c + 6] = data;
 		limitaddr = (adpcmreg[7]*256+adpcmreg[6] + 1) << 6;
+		adpcache = 0;
 //		LOG1("  limitaddr %.6x", limitaddr);
 		break;
 
@@ -762,6 +818,7 @@ inline void OPNABase::UpdateStatus()
 //
 void OPNABase::WriteRAM(uint data)
 {
+	FlushADPCMCache();
 #ifndef NO_BITTYPE_EMULATION
 	if (!(control2 & 2))
 	{
@@ -812,6 +869,7 @@ void OPNABase::WriteRAM(uint data)
 uint OPNABase::ReadRAM()
 {
 	uint data;
+	adpcache = 0;		// memaddr ưΤǡΥåϻȤʤ
 #ifndef NO_BITTYPE_EMULATION
 	if (!(control2 & 2))
 	{
@@ -877,6 +935,7 @@ inline int OPNABase::DecodeADPCMBSample(uint data)
 	};
 	adpcmx = Limit(adpcmx + table1[data] * adpcmd / 8, 32767, -32768);
 	adpcmd = Limit(adpcmd * table2[data] / 64, 24576, 127);
+	StoreADPCMCache();
 	return adpcmx;
 }	
 
@@ -887,6 +946,22 @@ inline int OPNABase::DecodeADPCMBSample(uint data)
 int OPNABase::ReadRAMN()
 {
 	uint data;
+	if (adpcache && adpcachepos < adpcache->length)
+	{
+		// ŸѤߡͤƸɥ쥹ʤ
+		adpcmx = adpcache->x[adpcachepos];
+		adpcmd = adpcache->d[adpcachepos];
+		adpcachepos++;
+#ifndef NO_BITTYPE_EMULATION
+		uint step = granuality > 0 ? (control2 & 2 ? 1 : 8) : 1;
+#else
+		uint step = granuality > 0 ? 1 << (granuality-1) : 1;
+#endif
+		memaddr += step;
+		if (memaddr & step)
+			return adpcmx;
+		goto check;
+	}
 	if (granuality > 0)
 	{
 #ifndef NO_BITTYPE_EMULATION
@@ -933,6 +1008,7 @@ int OPNABase::ReadRAMN()
 	DecodeADPCMBSample(data);
 	
 	// check
+check:
 	if (memaddr == stopaddr)
 	{
 		if (control1 & 0x10)
@@ -940,6 +1016,7 @@ int OPNABase::ReadRAMN()
 			memaddr = startaddr;
 			data = adpcmx;
 			adpcmx = 0, adpcmd = 127;
+			adpcachepos = 0;
 			return data;
 		}
 		else
@@ -956,6 +1033,79 @@ int OPNABase::ReadRAMN()
 	return adpcmx;
 }
 
+// ---------------------------------------------------------------------------
+//	ADPCM Ÿå
+//	Ʊץϲ٤ΤǡŸ adpcmx, adpcmd 
+//	 (start, stop, limit, ) ݻƤ2ܰʹߤ
+//	ɤ߽ФŸʤADPCM RAM ˽񤭹ޤ줿ΤƤ롥
+//
+void OPNABase::SelectADPCMCache()
+{
+	uint mode = control2 & 2;
+	ADPCMCache* c = &adpcmcache[0];
+	int i;
+	
+	for (i=0; i<adpcmcachenr; i++)
+	{
+		ADPCMCache* e = &adpcmcache[i];
+		if (e->length && e->start == startaddr && e->stop == stopaddr
+			&& e->limit == limitaddr && e->mode == mode)
+		{
+			c = e;
+			break;
+		}
+		if (!e->length || (c->length && e->used < c->used))
+			c = e;
+	}
+	if (i == adpcmcachenr)
+	{
+		c->start = startaddr, c->stop = stopaddr;
+		c->limit = limitaddr, c->mode = mode;
+		c->length = 0;
+	}
+	c->used = ++adpcachestamp;
+	adpcache = c;
+	adpcachepos = 0;
+}
+
+inline void OPNABase::StoreADPCMCache()
+{
+	ADPCMCache* c = adpcache;
+	if (!c)
+		return;
+	
+	if (adpcachepos >= c->size)
+	{
+		uint size = c->size ? c->size * 2 : 0x1000;
+		if (size > 0x80000)		// RAM ΤĹʤ롼פƤ
+		{
+			adpcache = 0;
+			return;
+		}
+		int16* x = new int16[size];
+		int16* d = new int16[size];
+		if (c->length)
+		{
+			memcpy(x, c->x, c->length * sizeof(int16));
+			memcpy(d, c->d, c->length * sizeof(int16));
+		}
+		delete[] c->x;
+		delete[] c->d;
+		c->x = x, c->d = d;
+		c->size = size;
+	}
+	c->x[adpcachepos] = adpcmx;
+	c->d[adpcachepos] = adpcmd;
+	c->length = ++adpcachepos;
+}
+
+void OPNABase::FlushADPCMCache()
+{
+	for (int i=0; i<adpcmcachenr; i++)
+		adpcmcache[i].length = 0;
+	adpcache = 0;
+}
+
 // ---------------------------------------------------------------------------
 //	ĥơɤߤ
 //
@@ -981,7 +1131,7 @@ inline void OPNABase::DecodeADPCMB()
 // ---------------------------------------------------------------------------
 //	ADPCM 
 //	
-void OPNABase::ADPCMBMix(Sample* dest, uint count)
+void OPNABase::ADPCMBMix(ISample* destl, ISample* destr, uint count)
 {
 	uint maskl = control2 & 0x80 ? -1 : 0;
 	uint maskr = control2 & 0x40 ? -1 : 0;
@@ -1005,9 +1155,8 @@ void OPNABase::ADPCMBMix(Sample* dest, uint count)
 						break;
 				}
 				int s = (adplc * apout0 + (8192-adplc) * apout1) >> 13;
-				StoreSample(dest[0], s & maskl);
-				StoreSample(dest[1], s & maskr);
-				dest += 2;
+				StoreISample(*destl++, s & maskl);
+				StoreISample(*destr++, s & maskr);
 				adplc -= adpld;
 			}
 			for (; count>0 && apout0; count--)
@@ -1018,9 +1167,8 @@ void OPNABase::ADPCMBMix(Sample* dest, uint count)
 					adplc += 8192;
 				}
 				int s = (adplc * apout1) >> 13;
-				StoreSample(dest[0], s & maskl);
-				StoreSample(dest[1], s & maskr);
-				dest += 2;
+				StoreISample(*destl++, s & maskl);
+				StoreISample(*destr++, s & maskr);
 				adplc -= adpld;
 			}
 		}
@@ -1040,9 +1188,8 @@ void OPNABase::ADPCMBMix(Sample* dest, uint count)
 				}
 				adplc -= 8192;
 				s >>= 13;
-				StoreSample(dest[0], s & maskl);
-				StoreSample(dest[1], s & maskr);
-				dest += 2;
+				StoreISample(*destl++, s & maskl);
+				StoreISample(*destr++, s & maskr);
 			}
 stop:
 			;
@@ -1057,10 +1204,10 @@ stop:
 
 // ---------------------------------------------------------------------------
 //	
-//	in:		buffer		
+//	in:		destl, destr	 (L, R)
 //			nsamples	ץ
 //
-void OPNABase::FMMix(Sample* buffer, int nsamples)
+void OPNABase::FMMix(ISample* destl, ISample* destr, int nsamples)
 {
 	if (fmvolume > 0)
 	{
@@ -1083,7 +1230,7 @@ void OPNABase::FMMix(Sample* buffer, int nsamples)
 
 		if (act & 0x555)
 		{
-			Mix6(buffer, nsamples, act);
+			Mix6(destl, destr, nsamples, act);
 		}
 	}
 }
@@ -1149,7 +1296,7 @@ inline void OPNABase::LFO()
 //
 #define IStoSample(s)	((Limit(s, 0x7fff, -0x8000) * fmvolume) >> 14)
 
-void OPNABase::Mix6(Sample* buffer, int nsamples, int activech)
+void OPNABase::Mix6(ISample* destl, ISample* destr, int nsamples, int activech)
 {
 	// Mix
 	ISample ibuf[4];
@@ -1161,16 +1308,15 @@ void OPNABase::Mix6(Sample* buffer, int nsamples, int activech)
 	idest[4] = &ibuf[pan[4]];
 	idest[5] = &ibuf[pan[5]];
 
-	Sample* limit = buffer + nsamples * 2;
-	for (Sample* dest = buffer; dest < limit; dest+=2)
+	for (int i=0; i<nsamples; i++)
 	{
 		ibuf[1] = ibuf[2] = ibuf[3] = 0;
 		if (activech & 0xaaa)
 			LFO(), MixSubSL(activech, idest);
 		else
 			MixSubS(activech, idest);
-		StoreSample(dest[0], IStoSample(ibuf[2] + ibuf[3]));
-		StoreSample(dest[1], IStoSample(ibuf[1] + ibuf[3]));
+		StoreISample(destl[i], IStoSample(ibuf[2] + ibuf[3]));
+		StoreISample(destr[i], IStoSample(ibuf[1] + ibuf[3]));
 	}
 }
 
@@ -1535,11 +1681,10 @@ void OPNA::SetReg(uint addr, uint data)
 // ---------------------------------------------------------------------------
 //	ꥺ
 //
-void OPNA::RhythmMix(Sample* buffer, uint count)
+void OPNA::RhythmMix(ISample* destl, ISample* destr, uint count)
 {
 	if (rhythmtvol < 128 && rhythm[0].sample && (rhythmkey & 0x3f))
 	{
-		Sample* limit = buffer + count * 2;
 		for (int i=0; i<6; i++)
 		{
 			Rhythm& r = rhythm[i];
@@ -1555,12 +1700,12 @@ void OPNA::RhythmMix(Sample* buffer, uint count)
 					maskl = maskr = 0;
 				}
 				
-				for (Sample* dest = buffer; dest<limit && r.pos < r.size; dest+=2)
+				for (uint j=0; j<count && r.pos < r.size; j++)
 				{
 					int sample = (r.sample[r.pos / 1024] * vol) >> 12;
 					r.pos += r.step;
-					StoreSample(dest[0], sample & maskl);
-					StoreSample(dest[1], sample & maskr);
+					StoreISample(destl[j], sample & maskl);
+					StoreISample(destr[j], sample & maskr);
 				}
 			}
 		}
@@ -1600,10 +1745,17 @@ void OPNA::SetVolumeADPCM(int db)
 //
 void OPNA::Mix(Sample* buffer, int nsamples)
 {
-	FMMix(buffer, nsamples);
-	psg.Mix(buffer, nsamples);
-	ADPCMBMix(buffer, nsamples);
-	RhythmMix(buffer, nsamples);
+	ISample* dest = LoadInterleaved(buffer, nsamples);
+	Mix(dest, dest + nsamples, nsamples);
+	StoreInterleaved(buffer, nsamples);
+}
+
+void OPNA::Mix(ISample* destl, ISample* destr, int nsamples)
+{
+	FMMix(destl, destr, nsamples);
+	psg.Mix(destl, destr, nsamples);
+	ADPCMBMix(destl, destr, nsamples);
+	RhythmMix(destl, destr, nsamples);
 }
 
 #endif // BUILD_OPNA
@@ -1899,7 +2051,7 @@ void OPNB::InitADPCMATable()
 // ---------------------------------------------------------------------------
 //	ADPCMA 
 //
-void OPNB::ADPCMAMix(Sample* buffer, uint count)
+void OPNB::ADPCMAMix(ISample* destl, ISample* destr, uint count)
 {
 	const static int decode_tableA1[16] = 
 	{
@@ -1909,7 +2061,6 @@ void OPNB::ADPCMAMix(Sample* buffer, uint count)
 
 	if (adpcmatvol < 128 && (adpcmakey & 0x3f))
 	{
-		Sample* limit = buffer + count * 2;
 		for (int i=0; i<6; i++)
 		{
 			ADPCMA& r = adpcma[i];
@@ -1925,8 +2076,7 @@ void OPNB::ADPCMAMix(Sample* buffer, uint count)
 				int db = Limit(adpcmatl+adpcmatvol+r.level+r.volume, 127, -31);
 				int vol = tltable[FM_TLPOS+(db << (FM_TLBITS-7))] >> 4;
 				
-				Sample* dest = buffer;
-				for ( ; dest<limit; dest+=2) 
+				for (uint j=0; j<count; j++) 
 				{
 					r.step += adpcmastep;
 					if (r.pos >= r.stop) 
@@ -1956,8 +2106,8 @@ void OPNB::ADPCMAMix(Sample* buffer, uint count)
 						r.adpcmd = Limit(r.adpcmd, 48*16, 0);
 					}
 					int sample = (r.adpcmx * vol) >> 10;
-					StoreSample(dest[0], sample & maskl);
-					StoreSample(dest[1], sample & maskr);
+					StoreISample(destl[j], sample & maskl);
+					StoreISample(destr[j], sample & maskr);
 				}
 			}
 		}
@@ -1995,10 +2145,17 @@ void OPNB::SetVolumeADPCMB(int db)
 //
 void OPNB::Mix(Sample* buffer, int nsamples)
 {
-	FMMix(buffer, nsamples);
-	psg.Mix(buffer, nsamples);
-	ADPCMBMix(buffer, nsamples);
-	ADPCMAMix(buffer, nsamples);
+	ISample* dest = LoadInterleaved(buffer, nsamples);
+	Mix(dest, dest + nsamples, nsamples);
+	StoreInterleaved(buffer, nsamples);
+}
+
+void OPNB::Mix(ISample* destl, ISample* destr, int nsamples)
+{
+	FMMix(destl, destr, nsamples);
+	psg.Mix(destl, destr, nsamples);
+	ADPCMBMix(destl, destr, nsamples);
+	ADPCMAMix(destl, destr, nsamples);
 }
 
 #endif // BUILD_OPNB
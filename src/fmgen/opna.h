@@ -49,6 +49,11 @@
 //		δؿϲΥޡȤΩƤ롥
 //		  Timer  Count  GetNextEvent ɬפ롥
 //	
+//	void Mix(ISample* destl, ISample* destr, int nsamples)	(forQUASI88)
+//		ƱL  R ̡ ( nsamples ) ˲ä롥
+//		åԥ󥰤 FM_SAMPLETYPE ˳ǼƱԤ롥
+//		L, R, L, R...  Mix ϡǤƤǤ롥
+//	
 //	void Reset()
 //		ꥻå()
 //
@@ -85,6 +90,7 @@ namespace FM
 	{
 	public:
 		OPNBase();
+		~OPNBase();
 		
 		bool	Init(uint c, uint r);
 		virtual void Reset();
@@ -98,6 +104,9 @@ namespace FM
 		void	SetPrescaler(uint p);
 		void	RebuildTimeTable();
 		
+		ISample* LoadInterleaved(const Sample* buffer, int nsamples);
+		void	StoreInterleaved(Sample* buffer, int nsamples);
+		
 		int		fmvolume;
 		
 		uint	clock;				// OPN å
@@ -113,6 +122,9 @@ namespace FM
 		void	TimerA();
 		uint8	prescale;
 		
+		ISample* mixbuf;			// L, R, L, R... ι (forQUASI88)
+		int		mixbufsize;
+		
 	protected:
 		Chip	chip;
 		PSG		psg;
@@ -144,8 +156,8 @@ namespace FM
 		uint	GetReg(uint addr);	
 	
 	protected:
-		void	FMMix(Sample* buffer, int nsamples);
-		void 	Mix6(Sample* buffer, int nsamples, int activech);
+		void	FMMix(ISample* destl, ISample* destr, int nsamples);
+		void 	Mix6(ISample* destl, ISample* destr, int nsamples, int activech);
 		
 		void	MixSubS(int activech, ISample**);
 		void	MixSubSL(int activech, ISample**);
@@ -156,13 +168,17 @@ namespace FM
 		void	LFO();
 
 		void	DecodeADPCMB();
-		void	ADPCMBMix(Sample* dest, uint count);
+		void	ADPCMBMix(ISample* destl, ISample* destr, uint count);
 
 		void	WriteRAM(uint data);
 		uint	ReadRAM();
 		int		ReadRAMN();
 		int		DecodeADPCMBSample(uint);
 		
+		void	SelectADPCMCache();
+		void	StoreADPCMCache();
+		void	FlushADPCMCache();
+		
 	// FM ط
 		uint8	pan[6];
 		uint8	fnum2[9];
@@ -209,6 +225,22 @@ namespace FM
 		uint8	control2;		// ADPCM ȥ쥸
 		uint8	adpcmreg[8];	// ADPCM 쥸ΰʬ
 
+	// ADPCM Ÿå
+		enum { adpcmcachenr = 8 };
+		struct ADPCMCache
+		{
+			uint	start, stop, limit, mode;	// 
+			uint	length;		// ŸѤߤ nibble 
+			uint	size;		// ݤ nibble 
+			uint	used;		// LRU 
+			int16*	x;			//  nibble Ÿ adpcmx
+			int16*	d;			//  nibble Ÿ adpcmd
+		};
+		ADPCMCache	adpcmcache[adpcmcachenr];
+		ADPCMCache*	adpcache;		// ΥץΥȥ
+		uint	adpcachepos;	// Ϥ nibble 
+		uint	adpcachestamp;
+
 		int		rhythmmask_;
 
 		Channel4 ch[6];
@@ -232,6 +264,7 @@ namespace FM
 		
 		void	Reset();
 		void 	Mix(Sample* buffer, int nsamples);
+		void 	Mix(ISample* destl, ISample* destr, int nsamples);
 		void 	SetReg(uint addr, uint data);
 		uint	GetReg(uint addr);
 		uint	ReadStatus() { return status & 0x03; }
@@ -268,6 +301,7 @@ namespace FM
 	
 		bool	SetRate(uint c, uint r, bool = false);
 		void 	Mix(Sample* buffer, int nsamples);
+		void 	Mix(ISample* destl, ISample* destr, int nsamples);
 
 		void	Reset();
 		void 	SetReg(uint addr, uint data);
@@ -297,7 +331,7 @@ namespace FM
 			uint	rate;		// פΤ졼
 		};
 	
-		void	RhythmMix(Sample* buffer, uint count);
+		void	RhythmMix(ISample* destl, ISample* destr, uint count);
 
 	// ꥺ಻ط
 		Rhythm	rhythm[6];
@@ -319,6 +353,7 @@ namespace FM
 	
 		bool	SetRate(uint c, uint r, bool = false);
 		void 	Mix(Sample* buffer, int nsamples);
+		void 	Mix(ISample* destl, ISample* destr, int nsamples);
 
 		void	Reset();
 		void 	SetReg(uint addr, uint data);
@@ -348,7 +383,7 @@ namespace FM
 		};
 	
 		int		DecodeADPCMASample(uint);
-		void	ADPCMAMix(Sample* buffer, uint count);
+		void	ADPCMAMix(ISample* destl, ISample* destr, uint count);
 		static void InitADPCMATable();
 		
 	// ADPCMA ط
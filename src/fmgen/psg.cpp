@@ -17,11 +17,13 @@ PSG::PSG()
 	MakeNoiseTable();
 	Reset();
 	mask = 0x3f;
+	mixbuf = 0;
+	mixbufsize = 0;
 }
 
 PSG::~PSG()
 {
-
+	delete[] mixbuf;
 }
 
 // ---------------------------------------------------------------------------
@@ -208,12 +210,66 @@ inline void PSG::StoreSample(Sample& dest, int32 data)
 		dest += data;
 }
 
+inline void PSG::StoreISample(int32& dest, int32 data)
+{
+	if (sizeof(Sample) == 2)
+		dest = Limit(dest + data, 0x7fff, -0x8000);
+	else
+		dest += data;
+}
+
+// ---------------------------------------------------------------------------
+//	ȡνϤѲ³ץ ( nsamples)
+//	scount  bit (toneshift+oversampling) ȿžޤǤΥƥå׿
+//
+inline int PSG::ToneRun(const uint8* chenable, int nsamples)
+{
+	const uint32 unit = 1 << (toneshift+oversampling);
+	int run = nsamples;
+	
+	for (int ch=0; ch<3; ch++)
+	{
+		if (chenable[ch] && speriod[ch])
+		{
+			uint32 steps = (unit - (scount[ch] & (unit-1)) + speriod[ch] - 1) / speriod[ch];
+			if (int(steps >> oversampling) < run)
+				run = steps >> oversampling;
+		}
+	}
+	return run;
+}
+
 // ---------------------------------------------------------------------------
 //	PCM ǡǤФ(2ch)
 //	dest		PCM ǡŸݥ
 //	nsamples	Ÿ PCM Υץ
 //
+//	L, R, L, R... ξϡL/R ̡˹Ƥͤľ
+//
 void PSG::Mix(Sample* dest, int nsamples)
+{
+	int i;
+
+	if (mixbufsize < nsamples)
+	{
+		delete[] mixbuf;
+		mixbuf = new int32[nsamples * 2];
+		mixbufsize = nsamples;
+	}
+	for (i=0; i<nsamples; i++)
+	{
+		mixbuf[i]            = dest[i*2+0];
+		mixbuf[nsamples + i] = dest[i*2+1];
+	}
+	Mix(mixbuf, mixbuf + nsamples, nsamples);
+	for (i=0; i<nsamples; i++)
+	{
+		dest[i*2+0] = (Sample) mixbuf[i];
+		dest[i*2+1] = (Sample) mixbuf[nsamples + i];
+	}
+}
+
+void PSG::Mix(int32* destl, int32* destr, int nsamples)
 {
 	uint8 chenable[3], nenable[3];
 	uint8 r7 = ~reg[7];
@@ -243,6 +299,28 @@ void PSG::Mix(Sample* dest, int nsamples)
 				// Υ̵
 				for (int i=0; i<nsamples; i++)
 				{
+					// ˥ȡȿžޤǤϽϤʤΤǡޤȤƽ񤭹
+					int run = ToneRun(chenable, nsamples - i);
+					if (run > 0)
+					{
+						int x, y, z;
+						x = (SCOUNT(0) & chenable[0]) - 1;
+						y = (SCOUNT(1) & chenable[1]) - 1;
+						z = (SCOUNT(2) & chenable[2]) - 1;
+						sample = ((olevel[0] + x) ^ x) + ((olevel[1] + y) ^ y) + ((olevel[2] + z) ^ z);
+						for (int k=0; k<run; k++)
+						{
+							StoreISample(*destl++, sample);
+							StoreISample(*destr++, sample);
+						}
+						scount[0] += speriod[0] * (uint32(run) << oversampling);
+						scount[1] += speriod[1] * (uint32(run) << oversampling);
+						scount[2] += speriod[2] * (uint32(run) << oversampling);
+						i += run;
+						if (i >= nsamples)
+							break;
+					}
+
 					sample = 0;
 					for (int j=0; j < (1 << oversampling); j++)
 					{
@@ -258,9 +336,8 @@ void PSG::Mix(Sample* dest, int nsamples)
 						scount[2] += speriod[2];
 					}
 					sample /= (1 << oversampling);
-					StoreSample(dest[0], sample);
-					StoreSample(dest[1], sample);
-					dest += 2;
+					StoreISample(*destl++, sample);
+					StoreISample(*destr++, sample);
 				}
 			}
 			else
@@ -292,9 +369,8 @@ void PSG::Mix(Sample* dest, int nsamples)
 						scount[2] += speriod[2];
 					}
 					sample /= (1 << oversampling);
-					StoreSample(dest[0], sample);
-					StoreSample(dest[1], sample);
-					dest += 2;
+					StoreISample(*destl++, sample);
+					StoreISample(*destr++, sample);
 				}
 			}
 
@@ -345,9 +421,8 @@ void PSG::Mix(Sample* dest, int nsamples)
 					scount[2] += speriod[2];
 				}
 				sample /= (1 << oversampling);
-				StoreSample(dest[0], sample);
-				StoreSample(dest[1], sample);
-				dest += 2;
+				StoreISample(*destl++, sample);
+				StoreISample(*destr++, sample);
 			}
 		}
 	}
@@ -27,6 +27,10 @@
 //	void Mix(Sample* dest, int nsamples)
 //		PCM  nsamples ʬ dest ǻϤޤ˲ä(û)
 //		ޤǲûʤΤǡǽ򥼥ꥢɬפ
+//
+//	void Mix(int32* destl, int32* destr, int nsamples)
+//		ƱL  R ̡˲ä (forQUASI88)
+//		åԥ󥰤 Sample ˳ǼƱԤ
 //	
 //	void Reset()
 //		ꥻåȤ
@@ -60,6 +64,7 @@ public:
 	~PSG();
 
 	void Mix(Sample* dest, int nsamples);
+	void Mix(int32* destl, int32* destr, int nsamples);
 	void SetClock(int clock, int rate);
 	
 	void SetVolume(int vol);
@@ -73,6 +78,8 @@ protected:
 	void MakeNoiseTable();
 	void MakeEnvelopTable();
 	static void StoreSample(Sample& dest, int32 data);
+	static void StoreISample(int32& dest, int32 data);
+	int ToneRun(const uint8* chenable, int nsamples);
 	
 	uint8 reg[16];
 
@@ -87,6 +94,9 @@ protected:
 	int volume;
 	int mask;
 
+	int32* mixbuf;			// L, R, L, R... ι (forQUASI88)
+	int mixbufsize;
+
 	static uint enveloptable[16][64];
 	static uint noisetable[noisetablesize];
 	static int EmitTable[32];
@@ -6,6 +6,8 @@
 char	file_disk[2][QUASI88_MAX_FILENAME];	/*ディスクイメージファイル名*/
 int	image_disk[2];	 	  		/*イメージ番号0〜31,-1は自動*/
 int	readonly_disk[2];			/*リードオンリーで開くなら真*/
+int	disk_journal = FALSE;			/*書込をジャーナル経由にする*/
+char	*dir_disk_overlay = NULL;		/*差分ジャーナルの保存先    */
 
 char	file_tape[2][QUASI88_MAX_FILENAME];	/* テープ入出力のファイル名 */
 char	file_prn[QUASI88_MAX_FILENAME];		/* パラレル出力のファイル名 */
@@ -33,6 +33,13 @@
 #include "wait.h"
 #include "snapshot.h"
 #include "suspend.h"
+#include "simd.h"
+#include "z80-prof.h"
+#include "stats.h"
+#include "remote.h"
+#include "bootcache.h"
+#include "diskcat.h"
+#include "basic.h"
 
 
 /*----------------------------------------------------------------------*/
@@ -309,6 +316,14 @@ static int o_diskimage(UNUSED_ARG)
     return oo_image(&config_image.d[DRIVE_1]);
 }
 
+static int o_kernels(char *str)
+{
+    int level = simd_str2level(str);
+    if (level < 0) return 1;
+    simd_level_force = level;
+    return 0;
+}
+
 
 
 /*----------------------------------------------------------------------*/
@@ -515,6 +530,24 @@ static const T_CONFIG_TABLE option_table[] =
   { 196, "diskimage",    X_STR,  &config_image.d[DRIVE_1], 0, 0, o_diskimage,  0        },
   { 197, "saveconfig",   X_FIX,  &save_config,     TRUE,                  0,0, OPT_SAVE },
   { 197, "nosaveconfig", X_FIX,  &save_config,     FALSE,                 0,0, OPT_SAVE },
+  { 198, "romcache",     X_STR,  &file_romcache,                        0,0,0, 0        },
+#ifdef	USE_REMOTE
+  { 199, "remote",       X_STR,  &file_remote,                          0,0,0, 0        },
+#else
+  {   0, "remote",       X_INV,  &invalid_arg,                          0,0,0, 0        },
+#endif
+  { 200, "bootcache",    X_FIX,  &use_bootcache,   TRUE,                  0,0, 0        },
+  { 200, "nobootcache",  X_FIX,  &use_bootcache,   FALSE,                 0,0, 0        },
+  { 201, "bootframe",    X_INT,  &bootcache_frame, 1, 36000,              0, 0        },
+  { 202, "bootpc",       X_INT,  &bootcache_pc,    -1, 0xffff,            0, 0        },
+  { 203, "diskjournal",  X_FIX,  &disk_journal,    TRUE,                  0,0, 0        },
+  { 203, "nodiskjournal",X_FIX,  &disk_journal,    FALSE,                 0,0, 0        },
+  { 204, "diskoverlay",  X_STR,  &dir_disk_overlay,                     0,0,0, 0        },
+  { 205, "audiosync",    X_FIX,  &audio_sync,      TRUE,                  0,0, OPT_SAVE },
+  { 205, "noaudiosync",  X_FIX,  &audio_sync,      FALSE,                 0,0, OPT_SAVE },
+  { 206, "audiolatency", X_INT,  &audio_sync_frames, 1, 60,               0, OPT_SAVE },
+  { 207, "diskcat",      X_FIX,  &use_diskcat,     TRUE,                  0,0, 0        },
+  { 207, "nodiskcat",    X_FIX,  &use_diskcat,     FALSE,                 0,0, 0        },
 
   /* 251〜299: デバッグ用オプション */
 
@@ -541,10 +574,12 @@ static const T_CONFIG_TABLE option_table[] =
   { 271, "nodebug",      X_FIX,  &debug_mode,      FALSE,                 0,0, 0        },
   { 272, "monitor",      X_FIX,  &debug_mode,      TRUE, 0, o_monitor,         0        },
   { 273, "fdcdebug",     X_FIX,  &fdc_debug_mode,  TRUE ,                 0,0, 0        },
+  { 274, "basconv",      X_STR,  &file_basconv,                         0,0,0, 0        },
 #else
   {   0, "debug",        X_INV,                                       0,0,0,0, 0        },
   {   0, "monitor",      X_INV,                                       0,0,0,0, 0        },
   {   0, "fdcdebug",     X_INV,                                       0,0,0,0, 0        },
+  {   0, "basconv",      X_INV,  &invalid_arg,                          0,0,0, 0        },
 #endif
 
   { 281, "nofont",       X_FIX,  &use_built_in_font,TRUE,                 0,0, 0        },
@@ -554,6 +589,12 @@ static const T_CONFIG_TABLE option_table[] =
   { 284, "fdc_debug",    X_INT,  &fdc_debug,       0, 3,                    0, 0        },
   { 285, "main_debug",   X_INT,  &main_debug,      0, 3,                    0, 0        },
   { 286, "sub_debug",    X_INT,  &sub_debug,       0, 3,                    0, 0        },
+  { 287, "kernels",      X_STR,  NULL,             0, 0, o_kernels,            0        },
+  { 288, "z80prof",      X_INT,  &z80prof_mode,    0, 3,                    0, 0        },
+  { 289, "statsfile",    X_STR,  &file_stats,                           0,0,0, 0        },
+  { 290, "statsinterval",X_INT,  &stats_interval,  1, 3600,                 0, 0        },
+  { 291, "statsdisp",    X_FIX,  &stats_disp,      TRUE,                  0,0, 0        },
+  { 291, "nostatsdisp",  X_FIX,  &stats_disp,      FALSE,                 0,0, 0        },
 
 
 #if 0
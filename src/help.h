@@ -107,10 +107,24 @@ static	void	help_msg_common(void)
    "    -statedir <path>        Set directory of STATE file\n"
    "    -noconfig               Not load config file\n"
    "    -compatrom <filename>   Specify ROM image file of P88SR.EXE\n"
+   "    -romcache <filename>    Use/create mmap-able ROM cache file\n"
+#ifdef	USE_REMOTE
+   "    -remote <path>          Accept commands on UNIX domain socket\n"
+#endif
+   "    -bootcache/-nobootcache Use/Not use boot state cache [-nobootcache]\n"
+   "    -bootframe <frames>     Save boot cache after <frames> frames [600]\n"
+   "    -bootpc <addr>          Save boot cache when main CPU reaches <addr>\n"
+   "    -diskjournal/-nodiskjournal\n"
+   "                            Write disk image via journal file [-nodiskjournal]\n"
+   "    -diskoverlay <path>     Keep disk image unchanged, save writes in <path>\n"
+   "    -diskcat/-nodiskcat     Use/Not use disk image catalog cache [-nodiskcat]\n"
    "    -resume                 stateload in start\n"
    "    -resumefile <filename>  stateload in start (state file is <filename>)\n"
    "    -focus                  Running quasi88 only in window focus\n"
    "    -sleep/-nosleep         Sleep/Not sleep during idle [-sleep]\n"
+   "    -audiosync/-noaudiosync Pace frames by audio output instead of timer\n"
+   "                            (if the audio driver supports) [-noaudiosync]\n"
+   "    -audiolatency <frames>  Audio output to keep queued in -audiosync [4]\n"
    "    -ro/-rw                 Open disk image file as read-only/read-write [-rw]\n"
    "    -ignore_ro              Treat RO disk image file as RW\n"
    "  ** DEBUG **\n"
@@ -128,10 +142,20 @@ static	void	help_msg_common(void)
    "    -playback <filename>    Play back all key inputs from the file <filename>\n"
    "    -timestop               Freeze real-time-clock\n"
    "    -vsync <hz>             Set VSYNC frequency [55.4]\n"
+   "    -kernels <isa>          Select optimized routines [auto]\n"
+   "                                c, sse2, ssse3, avx2, neon\n"
+   "    -z80prof <n>            Profile emulated Z80 code (1:main 2:sub 3:both)\n"
+   "    -statsfile <filename>   Write host-side counters as JSON periodically\n"
+   "    -statsinterval <sec>    Interval of -statsfile/-statsdisp [1]\n"
+   "    -statsdisp/-nostatsdisp Show counters in the status area [-nostatsdisp]\n"
 #ifdef	USE_MONITOR
    "    -debug                  enable to go to monitor mode\n"
    "    -monitor                start in monitor mode\n"
    "    -fdcdebug               print FDC status\n"
+   "    -basconv <filename>     Convert BASIC lists as listed in <filename>\n"
+   "                            and exit. Each line is 'e <text> <code>'\n"
+   "                            or 'd <code> <text>' (file names must not\n"
+   "                            contain spaces)\n"
 #endif
    "\n"
    ,
@@ -472,6 +472,10 @@ int	d88_write_unformat( OSD_FILE *fp, int drv, int img )
 
   }
 
+	/* ドライブにセットされたファイルなら、ID情報の索引を作り直す */
+
+  disk_index_rebuild( fp );
+
 	/* ファイル位置をもとの位置に戻す */
 
   if( (osd_fseek( fp, current, SEEK_SET )) ){ return D88_ERR_SEEK; }
@@ -604,6 +608,10 @@ int	d88_write_format( OSD_FILE *fp, int drv, int img )
 
   }
 
+	/* ドライブにセットされたファイルなら、ID情報の索引を作り直す */
+
+  disk_index_rebuild( fp );
+
 	/* ファイル位置をもとの位置に戻す */
 
   if( (osd_fseek( fp, current, SEEK_SET )) ){ return D88_ERR_SEEK; }
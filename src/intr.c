@@ -23,11 +23,7 @@
 
 
 
-int	intr_level;			/* OUT[E4] 割り込みレベル	*/
-int	intr_priority;			/* OUT[E4] 割り込み優先度	*/
-int	intr_sio_enable;		/* OUT[E6] 割り込みマスク SIO	*/ 
-int	intr_vsync_enable;		/* OUT[E6] 割り込みマスク VSYNC	*/ 
-int	intr_rtc_enable;		/* OUT[E6] 割り込みマスク RTC	*/ 
+/* 割り込みの状態は、マシン毎に machine->intr にある。(intr.h 参照) */
 
 
 
@@ -37,6 +33,8 @@ double	vsync_freq_hz   = DEFAULT_VSYNC_FREQ_HZ;   /* VSYNC 割込周期   [Hz]
 
 int	wait_rate     = 100;			/* ウエイト調整 比率    [%]  */
 int	wait_by_sleep = TRUE;			/* ウエイト調整時 sleep する */
+int	audio_sync    = FALSE;			/* サウンド出力でウエイト調整*/
+int	audio_sync_frames = 4;			/* その際の出力待ち [フレーム]*/
 
 
 
@@ -74,17 +72,17 @@ int	wait_by_sleep = TRUE;			/* ウエイト調整時 sleep する */
 
 /*****************************************************************************/
 
-int	state_of_cpu = 0;	/* メインCPUが処理したステート数	*/
-				/*	VSYNC割込発生時に初期化し、     */
-				/*	main_INT_update() 呼出時に加算	*/
-				/*	 (この関数は不定期に呼出される)	*/
-				/*					*/
-				/*	VSYNC発生から現時点迄に処理した	*/
-				/*	総ステート数は、以下の式になる。*/
-				/*					*/
-				/*	state_of_cpu+z80main_cpu.state0 */
-
-int	state_of_vsync;		/* VSYNC 1周期あたりのステート数	*/
+/* state_of_cpu	   メインCPUが処理したステート数			*/
+/*			VSYNC割込発生時に初期化し、			*/
+/*			main_INT_update() 呼出時に加算			*/
+/*			 (この関数は不定期に呼出される)			*/
+/*									*/
+/*			VSYNC発生から現時点迄に処理した			*/
+/*			総ステート数は、以下の式になる。		*/
+/*									*/
+/*			state_of_cpu+z80main_cpu.state0			*/
+/*									*/
+/* state_of_vsync  VSYNC 1周期あたりのステート数			*/
 
 int	no_wait	      = FALSE;		/* ウエイトなし			*/
 
@@ -92,36 +90,40 @@ int	boost	= 1;			/* ブースト			*/
 int	boost_cnt;
 
 
-	int	RS232C_flag    = FALSE;	/* RS232C */
-static	int	rs232c_intr_base;
-static	int	rs232c_intr_timer;
+					/* RS232C */
+#define	rs232c_intr_base	(machine->intr.rs232c_base)
+#define	rs232c_intr_timer	(machine->intr.rs232c_timer)
+
+					/* VSYNC */
+#define	vsync_intr_base		(machine->intr.vsync_base)
+#define	vsync_intr_timer	(machine->intr.vsync_timer)
 
-	int	VSYNC_flag     = FALSE;	/* VSYNC */
-static	int	vsync_intr_base;
-static	int	vsync_intr_timer;
+					/* VRTC (垂直帰線中:1or3 / 表示中:2) */
+#define	vrtc_base		(machine->intr.vrtc_top)
+#define	vrtc_base2		(machine->intr.vrtc_disp)
+#define	vrtc_timer		(machine->intr.vrtc_remain)
 
-	int	ctrl_vrtc      = 1;	/* VRTC (垂直帰線中:1or3 / 表示中:2) */
-static	int	vrtc_base;
-static	int	vrtc_base2;
-static	int	vrtc_timer;
+					/* RTC */
+#define	rtc_intr_base		(machine->intr.rtc_base)
+#define	rtc_intr_timer		(machine->intr.rtc_timer)
 
-	int	RTC_flag       = FALSE;	/* RTC */
-static	int	rtc_intr_base;
-static	int	rtc_intr_timer;
+					/* SOUND Timer-A/Timer-B */
+#define	SOUND_level		(machine->intr.sound_level)
+#define	SOUND_edge		(machine->intr.sound_edge)
+#define	sd_A_intr_base		(machine->intr.sd_A_base)
+#define	sd_A_intr_timer		(machine->intr.sd_A_timer)
+#define	sd_B_intr_base		(machine->intr.sd_B_base)
+#define	sd_B_intr_timer		(machine->intr.sd_B_timer)
+#define	sd2_BRDY_intr_base	(machine->intr.sd2_BRDY_base)
+#define	sd2_BRDY_intr_timer	(machine->intr.sd2_BRDY_timer)
+#define	sd2_EOS_intr_base	(machine->intr.sd2_EOS_base)
+#define	sd2_EOS_intr_timer	(machine->intr.sd2_EOS_timer)
 
-	int	SOUND_flag     = FALSE;	/* SOUND Timer-A/Timer-B */
-static	int	SOUND_level    = FALSE;
-static	int	SOUND_edge     = FALSE;
-static	int	sd_A_intr_base;
-static	int	sd_A_intr_timer;
-static	int	sd_B_intr_base;
-static	int	sd_B_intr_timer;
-static	int	sd2_BRDY_intr_base;
-static	int	sd2_BRDY_intr_timer;
-static	int	sd2_EOS_intr_base;
-static	int	sd2_EOS_intr_timer;
+				/* サウンドの分割出力 (0 なら分割なし) */
+#define	sound_part_base		(machine->intr.sd_part_base)
+#define	sound_part_timer	(machine->intr.sd_part_timer)
 
-static	int	vsync_count;		/* test (計測用) */
+#define	vsync_count		(machine->intr.vsync_counter)	/* test (計測用) */
 
 
 
@@ -148,6 +150,14 @@ static	void	interval_work_init_generic( void )
 
   if( boost < 1 ) boost = 1;
   boost_cnt = 0;
+
+  sound_part_base = 0;
+  if( xmame_cfg_get_sound_update() > 0 ){
+    sound_part_base = (int) (CPU_CLOCK * xmame_cfg_get_sound_update()
+					/ xmame_cfg_get_sample_freq());
+    if( sound_part_base < 1 ) sound_part_base = 1;
+  }
+  sound_part_timer = sound_part_base;
 }
 
 
@@ -245,8 +255,8 @@ void	interval_work_set_TIMER_B( void )
 /*
  * サウンドの 各種フラグ および プリスケーラー値変更時に呼ぶ
  */
-static	int	sound_flags_update     = 0;
-static	int	sound_prescaler_update = 0;
+#define	sound_flags_update	(machine->intr.sd_flags_update)
+#define	sound_prescaler_update	(machine->intr.sd_prescaler_update)
 
 void	change_sound_flags( int port )
 {
@@ -464,6 +474,20 @@ void	main_INT_update( void )
   icount = MIN( icount, vsync_intr_timer );
 
 
+		/* -------- サウンドの分割出力 -------- */
+
+  if( sound_part_base ){
+    sound_part_timer -= z80main_cpu.state0;
+    if( sound_part_timer < 0 ){
+      sound_part_timer += sound_part_base;
+      if( sound_part_timer < 0 ) sound_part_timer = sound_part_base;
+      CPU_BREAKOFF();
+      quasi88_event_flags |= EVENT_AUDIO_PART;
+    }
+    icount = MIN( icount, sound_part_timer );
+  }
+
+
 		/* -------- VRTC 処理 -------- */
 
   if( ctrl_vrtc == 1 ){				/* VSYNC から 一定時間 */
@@ -731,13 +755,14 @@ static	int	wait_sleep_min_us_dummy;
 #define	SID3	"INT3"
 #define	SID4	"INT4"
 
+/* 処理中のマシンのワークは、machine_0 のワークから読み替えて扱う */
 static	T_SUSPEND_W	suspend_intr_work[]=
 {
-  { TYPE_INT,	&intr_level,		},
-  { TYPE_INT,	&intr_priority,		},
-  { TYPE_INT,	&intr_sio_enable,	},
-  { TYPE_INT,	&intr_vsync_enable,	},
-  { TYPE_INT,	&intr_rtc_enable,	},
+  { TYPE_INT,	&machine_0.intr.level,	},
+  { TYPE_INT,	&machine_0.intr.priority,	},
+  { TYPE_INT,	&machine_0.intr.sio_enable,	},
+  { TYPE_INT,	&machine_0.intr.vsync_enable,	},
+  { TYPE_INT,	&machine_0.intr.rtc_enable,	},
 
   { TYPE_DOUBLE,&cpu_clock_mhz,		},
   { TYPE_DOUBLE,&sound_clock_mhz,	},
@@ -747,54 +772,54 @@ static	T_SUSPEND_W	suspend_intr_work[]=
   { TYPE_INT,	&wait_by_sleep_dummy,		},
   { TYPE_LONG,	&wait_sleep_min_us_dummy,	},
 
-  { TYPE_INT,	&state_of_cpu,		},
-  { TYPE_INT,	&state_of_vsync,	},
+  { TYPE_INT,	&machine_0.intr.cpu_states,	},
+  { TYPE_INT,	&machine_0.intr.vsync_states,	},
 
   { TYPE_INT,	&no_wait,		},
 
-  { TYPE_INT,	&RS232C_flag,		},
-  { TYPE_INT,	&rs232c_intr_base,	},
-  { TYPE_INT,	&rs232c_intr_timer,	},
+  { TYPE_INT,	&machine_0.intr.rs232c_flag,	},
+  { TYPE_INT,	&machine_0.intr.rs232c_base,	},
+  { TYPE_INT,	&machine_0.intr.rs232c_timer,	},
 
-  { TYPE_INT,	&VSYNC_flag,		},
-  { TYPE_INT,	&vsync_intr_base,	},
-  { TYPE_INT,	&vsync_intr_timer,	},
+  { TYPE_INT,	&machine_0.intr.vsync_flag,	},
+  { TYPE_INT,	&machine_0.intr.vsync_base,	},
+  { TYPE_INT,	&machine_0.intr.vsync_timer,	},
 
-  { TYPE_INT,	&ctrl_vrtc,		},
-  { TYPE_INT,	&vrtc_base,		},
-  { TYPE_INT,	&vrtc_timer,		},
+  { TYPE_INT,	&machine_0.intr.vrtc,	},
+  { TYPE_INT,	&machine_0.intr.vrtc_top,	},
+  { TYPE_INT,	&machine_0.intr.vrtc_remain,	},
 
-  { TYPE_INT,	&RTC_flag,		},
-  { TYPE_INT,	&rtc_intr_base,		},
-  { TYPE_INT,	&rtc_intr_timer,	},
+  { TYPE_INT,	&machine_0.intr.rtc_flag,	},
+  { TYPE_INT,	&machine_0.intr.rtc_base,	},
+  { TYPE_INT,	&machine_0.intr.rtc_timer,	},
 
-  { TYPE_INT,	&SOUND_flag,		},
-  { TYPE_INT,	&sd_A_intr_base,	},
-  { TYPE_INT,	&sd_A_intr_timer,	},
-  { TYPE_INT,	&sd_B_intr_base,	},
-  { TYPE_INT,	&sd_B_intr_timer,	},
+  { TYPE_INT,	&machine_0.intr.sound_flag,	},
+  { TYPE_INT,	&machine_0.intr.sd_A_base,	},
+  { TYPE_INT,	&machine_0.intr.sd_A_timer,	},
+  { TYPE_INT,	&machine_0.intr.sd_B_base,	},
+  { TYPE_INT,	&machine_0.intr.sd_B_timer,	},
 
-  { TYPE_INT,	&sound_flags_update,	},
-  { TYPE_INT,	&sound_prescaler_update,},
+  { TYPE_INT,	&machine_0.intr.sd_flags_update,	},
+  { TYPE_INT,	&machine_0.intr.sd_prescaler_update,	},
 
-  { TYPE_INT,	&sd2_BRDY_intr_base,	},
-  { TYPE_INT,	&sd2_BRDY_intr_timer,	},
-  { TYPE_INT,	&sd2_EOS_intr_base,	},
-  { TYPE_INT,	&sd2_EOS_intr_timer,	},
+  { TYPE_INT,	&machine_0.intr.sd2_BRDY_base,	},
+  { TYPE_INT,	&machine_0.intr.sd2_BRDY_timer,	},
+  { TYPE_INT,	&machine_0.intr.sd2_EOS_base,	},
+  { TYPE_INT,	&machine_0.intr.sd2_EOS_timer,	},
 
   { TYPE_END,	0			},
 };
 
 static	T_SUSPEND_W	suspend_intr_work2[]=
 {
-  { TYPE_INT,	&vrtc_base2,		},
+  { TYPE_INT,	&machine_0.intr.vrtc_disp,	},
   { TYPE_END,	0			},
 };
 
 static	T_SUSPEND_W	suspend_intr_work3[]=
 {
-  { TYPE_INT,	&SOUND_level,		},
-  { TYPE_INT,	&SOUND_edge,		},
+  { TYPE_INT,	&machine_0.intr.sound_level,	},
+  { TYPE_INT,	&machine_0.intr.sound_edge,	},
   { TYPE_END,	0			},
 };
 
@@ -2,11 +2,49 @@
 #define INTR_H_INCLUDED
 
 
-extern	int	intr_level;			/* OUT[E4] ߥ٥ */
-extern	int	intr_priority;			/* OUT[E4] ͥ */
-extern	int	intr_sio_enable;		/* OUT[E6] ޥ SIO */ 
-extern	int	intr_vsync_enable;		/* OUT[E6] ޥVSYNC*/ 
-extern	int	intr_rtc_enable;		/* OUT[E6] ޥ RTC */ 
+typedef	struct {			/* ޥγߤξ	*/
+
+  int	level;				/* OUT[E4] ߥ٥ */
+  int	priority;			/* OUT[E4] ͥ */
+  int	sio_enable;			/* OUT[E6] ޥ SIO */
+  int	vsync_enable;			/* OUT[E6] ޥVSYNC*/
+  int	rtc_enable;			/* OUT[E6] ޥ RTC */
+
+  int	cpu_states;			/*ᥤCPU̿ */
+  int	vsync_states;			/* VSYNCΥơȿ   */
+
+  int	vrtc;				/* 1:ľ  0: ɽ */
+
+  int	rs232c_flag;			/* Ƽ߿ե饰 */
+  int	vsync_flag;
+  int	rtc_flag;
+  int	sound_flag;
+  int	sound_level;
+  int	sound_edge;
+
+  int	rs232c_base,   rs232c_timer;	/* ƼߤμȻĤ */
+  int	vsync_base,    vsync_timer;
+  int	vrtc_top,      vrtc_disp,	vrtc_remain;
+  int	rtc_base,      rtc_timer;
+  int	sd_A_base,     sd_A_timer;
+  int	sd_B_base,     sd_B_timer;
+  int	sd2_BRDY_base, sd2_BRDY_timer;
+  int	sd2_EOS_base,  sd2_EOS_timer;
+  int	sd_part_base,  sd_part_timer;
+
+  int	sd_flags_update;
+  int	sd_prescaler_update;
+
+  int	vsync_counter;			/* test (¬) */
+
+} T_INTR;
+
+					/* Υޥγ	*/
+#define	intr_level		(machine->intr.level)
+#define	intr_priority		(machine->intr.priority)
+#define	intr_sio_enable		(machine->intr.sio_enable)
+#define	intr_vsync_enable	(machine->intr.vsync_enable)
+#define	intr_rtc_enable		(machine->intr.rtc_enable)
 
 
 
@@ -15,11 +53,13 @@ extern	double	sound_clock_mhz;	/* 
 extern	double	vsync_freq_hz;		/* VSYNC ߤμ	    [Hz]  */
 
 
-extern	int	state_of_cpu;			/*ᥤCPU̿ */
-extern	int	state_of_vsync;			/* VSYNCΥơȿ   */
+#define	state_of_cpu	(machine->intr.cpu_states)	/*ᥤCPU̿ */
+#define	state_of_vsync	(machine->intr.vsync_states)	/* VSYNCΥơȿ   */
 
 extern	int	wait_rate;			/* Ĵ Ψ    [%]  */
 extern	int	wait_by_sleep;			/* Ĵ sleep  */
+extern	int	audio_sync;			/* ɽϤǥĴ*/
+extern	int	audio_sync_frames;		/* κݤνԤ [ե졼]*/
 
 extern	int	no_wait;			/* Ȥʤ		*/
 
@@ -29,12 +69,12 @@ extern	int	boost_cnt;			/* 			*/
 
 
 
-extern	int	ctrl_vrtc;			/* 1:ľ  0: ɽ */
+#define	ctrl_vrtc	(machine->intr.vrtc)	/* 1:ľ  0: ɽ */
 
-extern	int	VSYNC_flag;			/* Ƽ߿ե饰 */
-extern	int	RTC_flag;
-extern	int	SOUND_flag;
-extern	int	RS232C_flag;
+#define	VSYNC_flag	(machine->intr.vsync_flag)	/* Ƽ߿ե饰 */
+#define	RTC_flag	(machine->intr.rtc_flag)
+#define	SOUND_flag	(machine->intr.sound_flag)
+#define	RS232C_flag	(machine->intr.rs232c_flag)
 
 
 
@@ -62,4 +102,7 @@ int	main_INT_chk( void );
 
 int	quasi88_info_vsync_count(void);
 
+
+#include "machine.h"
+
 #endif	/* INTR_H_INCLUDED */
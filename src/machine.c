@@ -0,0 +1,58 @@
+/************************************************************************/
+/*									*/
+/* マシン (PC-88 1台分) の状態						*/
+/*									*/
+/************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "quasi88.h"
+#include "machine.h"
+
+
+
+T_MACHINE	machine_0;		/* 最初のマシン (起動時はこれを使う) */
+T_MACHINE	*machine = &machine_0;	/* 処理中のマシン		     */
+
+
+
+/*----------------------------------------------------------------------
+ * マシンの生成・破棄
+ *	生成したマシンは、ワークが全て 0 (ポインタは NULL) の状態。
+ *	machine をこのマシンに切り替えてから memory_allocate() などで
+ *	初期化する。破棄は、memory_free() でメモリを解放してから行う。
+ *----------------------------------------------------------------------*/
+T_MACHINE	*machine_create( void )
+{
+  T_MACHINE *m = (T_MACHINE *)malloc( sizeof(T_MACHINE) );
+
+  if( m ){
+    memset( m, 0, sizeof(T_MACHINE) );
+  }
+  return m;
+}
+
+void	machine_destroy( T_MACHINE *m )
+{
+  if( m && m != &machine_0 ){
+    if( machine == m ) machine = &machine_0;
+    free( m );
+  }
+}
+
+
+
+/*----------------------------------------------------------------------
+ * machine_0 のメンバを指すポインタを、処理中のマシンの同じメンバを指す
+ * ポインタに読み替える。それ以外のポインタは、そのまま返す。
+ *----------------------------------------------------------------------*/
+void	*machine_relocate( void *ptr )
+{
+  char *p = (char *)ptr;
+
+  if( (char *)&machine_0 <= p && p < (char *)(&machine_0 + 1) ){
+    return (char *)machine + ( p - (char *)&machine_0 );
+  }
+  return ptr;
+}
@@ -0,0 +1,47 @@
+#ifndef MACHINE_H_INCLUDED
+#define MACHINE_H_INCLUDED
+
+/*
+ * ޥ (PC-88 1ʬ) ξ
+ *
+ *	CPU (memory.c) (intr.c) ξ֤ޤȤ᤿Ρ
+ *	ߥ졼ϡΥޥ machine ξ֤Ȥäư롣
+ *	ѿ̾ (z80main_cpu, main_ram, intr_level ʤ) ϡmachine 
+ *	ФؤޥȤƻĤƤΤǡΤޤ޻Ȥ롣
+ *
+ *	machine_create() Ǻäޥ machine ڤؤС̤Υޥ
+ *	ȤƽǤ롣(FDCCRTC/DMACɥܡɡI/O ʤɤ
+ *	֤ϡޤޥʬƤʤ)
+ *
+ *	ơȥ֤˥ѿʤɤŪʥơ֥Ǥϡǽ
+ *	ޥ machine_0 ΥФؤƤȤ machine_relocate() 
+ *	ΥޥΥФɤؤ롣
+ */
+
+#include "z80.h"
+#include "memory.h"
+#include "intr.h"
+
+
+typedef	struct T_MACHINE {
+
+  z80arch	main_cpu;		/* ᥤ CPU			*/
+  z80arch	sub_cpu;		/*  CPU			*/
+
+  T_MEMORY	mem;			/* 			*/
+  T_INTR	intr;			/* 			*/
+
+} T_MACHINE;
+
+
+extern	T_MACHINE	machine_0;	/* ǽΥޥ			*/
+extern	T_MACHINE	*machine;	/* Υޥ		*/
+
+
+T_MACHINE	*machine_create( void );
+void		machine_destroy( T_MACHINE *m );
+
+void		*machine_relocate( void *ptr );
+
+
+#endif	/* MACHINE_H_INCLUDED */
@@ -37,6 +37,8 @@ char	*file_compatrom = NULL;			/* P88SR emu のROMを使う*/
 
 int	has_kanji_rom   = FALSE;		/* 漢字ROMの有無	*/
 
+char	*file_romcache  = NULL;			/* ROMキャッシュファイル	*/
+
 int	linear_ext_ram = TRUE;			/* 拡張RAMを連続させる	*/
 
 
@@ -96,27 +98,7 @@ static char *rom_list[ ROM_END ][5] =
 
 
 
-byte	*main_rom;			/* メイン ROM [0x8000] (32KB)	*/
-byte	(*main_rom_ext)[0x2000];	/* 拡張 ROM [4][0x2000](8KB *4)	*/
-byte	*main_rom_n;			/* N-BASIC [0x8000]    (32KB)	*/
-byte	*main_ram;			/* メイン RAM [0x10000](64KB)	*/
-byte	*main_high_ram;			/* 高速 RAM(の裏)[0x1000] (4KB)	*/
-byte	(*kanji_rom)[65536][2];		/* 漢字ＲＯＭ[2][65536][2]	*/
-byte	*sub_romram;			/* サブ ROM/RAM [0x8000] (32KB)	*/
-
-byte	(*ext_ram)[0x8000];		/* 拡張 RAM[4][0x8000](32KB*4〜)*/
-byte	(*jisho_rom)[0x4000];		/* 辞書 ROM[32][0x4000](16KB*32)*/
-
-bit8	(*main_vram)[4];		/* VRAM[0x4000][4](=G/R/G/pad)	*/
-bit8	*font_rom;			/* フォントイメージROM[8*256*2]	*/
-
-bit8	*font_pcg;			/* フォントイメージROM(PCG用)	*/
-bit8	*font_mem;			/* フォントイメージROM(固定 )	*/
-bit8	*font_mem2;			/* フォントイメージROM(固定2)	*/
-bit8	*font_mem3;			/* フォントイメージROM(固定3)	*/
-
-byte	*dummy_rom;			/* ダミーROM (32KB)		*/
-byte	*dummy_ram;			/* ダミーRAM (32KB)		*/
+/* メモリへのポインタは、マシン毎に machine->mem にある。(memory.h 参照) */
 
 
 
@@ -310,36 +292,295 @@ static	void	load_compat_rom_close( OSD_FILE *fp )
 
 #define	FONT_SZ	(8*256*1)
 
-int	memory_allocate( void )
+/****************************************************************************
+ * ROMキャッシュ
+ *	ロードした ROM イメージを 1つのファイルにまとめておき、次回以降の
+ *	起動時は、そのファイルをメモリにマップして使う。
+ *	漢字ROM・辞書ROM はマップした領域をそのまま参照するので、同じ
+ *	キャッシュを使う複数のプロセスで、物理メモリが共有される。
+ *	その他の小さな ROM は書き換えられることがある (ROMバージョンの変更、
+ *	モニターでの書き込みなど) ので、確保したメモリにコピーする。
+ *
+ *	ファイルの構成は、ヘッダ (1ページ) に続けて、以下の順に格納する。
+ *	各ブロックのサイズは 4KB の倍数なので、どれもページ境界に並ぶ。
+ *
+ *	ROMディレクトリなどの設定や、ROMファイルのサイズ・更新時刻が変わった
+ *	り、中身のハッシュが一致しない場合は、キャッシュを使わずに通常のロード
+ *	を行い、キャッシュを作り直す。
+ *****************************************************************************/
+#define	ROMCACHE_MAGIC		"Q88ROMC"
+#define	ROMCACHE_VERSION	(1)
+#define	ROMCACHE_PAGE		(0x1000)
+
+enum {
+  RC_MAIN, RC_EXT, RC_N, RC_SUB, RC_FONT, RC_FONT2, RC_FONT3,
+  RC_KANJI, RC_JISHO, RC_END
+};
+static const int romcache_block_size[ RC_END ] =
 {
-  int	size;
+  0x8000, 0x8000, 0x8000, 0x8000, 0x1000, 0x1000, 0x1000, 0x40000, 0x80000,
+};
 
+typedef struct {
+  char	magic[8];
+  bit32	version;
+  bit32	key;			/* ROM ディレクトリ等の設定のハッシュ	*/
+  bit32	hash;			/* ヘッダ以降の中身のハッシュ		*/
+  bit32	size;			/* ヘッダ以降のサイズ			*/
+  bit32	has_kanji_rom;
+  bit32	has_jisho_rom;
+  bit32	font_loaded;
+} T_ROMCACHE_HEADER;
 
-		/* 標準メモリを確保 */
 
-  mem_alloc_start( "Allocating memory for standard ROM/RAM..." );
-  {
-    main_rom     = (byte *)           mem_alloc( sizeof(byte) *  0x8000 );
-    main_rom_ext = (byte(*)[0x2000])  mem_alloc( sizeof(byte) *  0x2000 *4 );
-    main_rom_n   = (byte *)           mem_alloc( sizeof(byte) *  0x8000 );
-    sub_romram   = (byte *)           mem_alloc( sizeof(byte) *  0x8000 );
+static	bit32	romcache_hash( bit32 h, const byte *p, long size )
+{
+  while( size-- ){			/* FNV-1a (32bit) */
+    h ^= *p++;
+    h *= 16777619u;
+  }
+  return h;
+}
 
-    main_ram     = (byte *)           mem_alloc( sizeof(byte) * 0x10000 );
-    main_high_ram= (byte *)           mem_alloc( sizeof(byte) *  0x1000 );
-    main_vram    = (byte(*)[0x4])     mem_alloc( sizeof(byte) *  0x4000 *4 );
+/* ファイル名と、そのファイルのサイズ・更新時刻 (あれば) をハッシュに加える */
+static	bit32	romcache_hash_file( bit32 h, const char *filename, int *found )
+{
+  long stamp[2];
 
-    kanji_rom    = (byte(*)[65536][2])mem_alloc( sizeof(byte)*2*65536*2 );
+  *found = osd_file_stamp( filename, &stamp[0], &stamp[1] );
+  if( *found ){
+    h = romcache_hash( h, (const byte *)filename, strlen(filename)+1 );
+    h = romcache_hash( h, (const byte *)stamp, sizeof(stamp) );
+  }
+  return h;
+}
 
-    font_pcg     = (byte *)           mem_alloc( sizeof(byte)*8*256*2 );
-    font_mem     = (byte *)           mem_alloc( sizeof(byte)*8*256*2 );
-    font_mem2    = (byte *)           mem_alloc( sizeof(byte)*8*256*2 );
-    font_mem3    = (byte *)           mem_alloc( sizeof(byte)*8*256*2 );
+static	bit32	romcache_key( void )
+{
+  const char *dir = osd_dir_rom();
+  char  buf[ OSD_MAX_FILENAME ];
+  bit32 h = 2166136261u;
+  byte  f = (byte)use_built_in_font;
+  int   i, j, found;
+
+  if( dir )            h = romcache_hash( h, (const byte *)dir, strlen(dir)+1 );
+  if( file_compatrom ) h = romcache_hash( h, (const byte *)file_compatrom,
+					       strlen(file_compatrom)+1 );
+  h = romcache_hash( h, &f, 1 );
+
+		/* ROMファイルが差し替えられたら、キーが変わるようにする */
+		/* (load_rom() と同じく、最初に見つかったファイルを使う) */
+
+  if( file_compatrom ){
+    h = romcache_hash_file( h, file_compatrom, &found );
   }
-  if( mem_alloc_finish()==FALSE ){
-    return 0;
+  if( dir ){
+    for( i=0; i<ROM_END; i++ ){
+      for( j=0; rom_list[i][j]; j++ ){
+	if( osd_path_join( dir, rom_list[i][j], buf, OSD_MAX_FILENAME )==FALSE )
+	  break;
+	h = romcache_hash_file( h, buf, &found );
+	if( found ) break;
+      }
+    }
   }
+  return h;
+}
+
+#define	romcache_map		(machine->mem.cache_map)	/* マップした ROMキャッシュ */
+#define	romcache_map_size	(machine->mem.cache_map_size)
+
+/* ptr が ROMキャッシュのマップ領域内なら真 */
+static	int	romcache_mapped( void *ptr )
+{
+  return ( romcache_map &&
+	   (byte *)romcache_map <= (byte *)ptr &&
+	   (byte *)ptr < (byte *)romcache_map + romcache_map_size );
+}
+
+static	long	romcache_payload_size( void )
+{
+  int i;
+  long size = 0;
+  for( i=0; i<RC_END; i++ ) size += romcache_block_size[i];
+  return size;
+}
+
 
+/*
+ * ROMキャッシュをマップして、ROMイメージを取り出す。成功したら真を返す。
+ */
+static	int	romcache_load( void )
+{
+  const T_ROMCACHE_HEADER *hdr;
+  const byte *p;
+  void   *map;
+  size_t map_size;
 
+  if( file_romcache == NULL ) return FALSE;
+
+  if( verbose_proc ){ printf( "Mapping ROM cache %s ...", file_romcache ); }
+
+  map = osd_file_map( file_romcache, &map_size );
+  if( map == NULL ){
+    if( verbose_proc ){ printf( "Not Found\n" ); }
+    return FALSE;
+  }
+
+  hdr = (const T_ROMCACHE_HEADER *)map;
+  p   = (const byte *)map + ROMCACHE_PAGE;
+
+  if( map_size != ROMCACHE_PAGE + (size_t)romcache_payload_size()     ||
+      memcmp( hdr->magic, ROMCACHE_MAGIC, sizeof(hdr->magic) ) != 0    ||
+      hdr->version != ROMCACHE_VERSION                                 ||
+      hdr->size    != (bit32)romcache_payload_size()                   ||
+      hdr->key     != romcache_key()                                   ||
+      hdr->hash    != romcache_hash( 2166136261u, p, hdr->size ) ){
+
+    if( verbose_proc ){ printf( "Invalid (rebuild)\n" ); }
+    osd_file_unmap( map, map_size );
+    return FALSE;
+  }
+
+		/* 書き換えられることのある ROM は、マシン毎にコピー */
+
+  memcpy( main_rom,            p, 0x8000 );  p += romcache_block_size[ RC_MAIN ];
+  memcpy( &main_rom_ext[0][0], p, 0x8000 );  p += romcache_block_size[ RC_EXT ];
+  memcpy( main_rom_n,          p, 0x8000 );  p += romcache_block_size[ RC_N ];
+  memcpy( sub_romram,          p, 0x8000 );  p += romcache_block_size[ RC_SUB ];
+  memcpy( font_mem,            p, 0x1000 );  p += romcache_block_size[ RC_FONT ];
+  memcpy( font_mem2,           p, 0x1000 );  p += romcache_block_size[ RC_FONT2 ];
+  memcpy( font_mem3,           p, 0x1000 );  p += romcache_block_size[ RC_FONT3 ];
+  font_loaded = hdr->font_loaded;
+
+		/* 漢字ROM・辞書ROM は、マップした領域をそのまま使う */
+
+  romcache_map      = map;
+  romcache_map_size = map_size;
+  kanji_rom         = (byte(*)[65536][2])p;
+  has_kanji_rom     = hdr->has_kanji_rom;
+  p += romcache_block_size[ RC_KANJI ];
+  if( hdr->has_jisho_rom && use_jisho_rom ){
+    jisho_rom       = (byte(*)[0x4000])p;
+  }
+
+  if( verbose_proc ){ printf( "OK\n" ); }
+  return TRUE;
+}
+
+
+/*
+ * ロードした ROMイメージから、ROMキャッシュを作成する
+ */
+static	int	romcache_write( OSD_FILE *fp, const byte *p, int size, bit32 *h )
+{
+  static const byte zero[ ROMCACHE_PAGE ];
+  int ok = TRUE;
+
+  if( p ){
+    *h = romcache_hash( *h, p, size );
+    if( osd_fwrite( p, sizeof(byte), size, fp ) != (size_t)size ) ok = FALSE;
+  }else{
+    while( size > 0 ){			/* p が NULL なら 0 で埋める */
+      *h = romcache_hash( *h, zero, ROMCACHE_PAGE );
+      if( osd_fwrite( zero, sizeof(byte), ROMCACHE_PAGE, fp )
+						!= ROMCACHE_PAGE ) ok = FALSE;
+      size -= ROMCACHE_PAGE;
+    }
+  }
+  return ok;
+}
+
+static	void	romcache_save( void )
+{
+  T_ROMCACHE_HEADER hdr;
+  OSD_FILE *fp;
+  char  tmp[ OSD_MAX_FILENAME ];
+  byte  *jisho = (byte *)jisho_rom;
+  byte  *jisho_tmp = NULL;
+  bit32 h;
+  int   ok = TRUE;
+
+  if( verbose_proc ){ printf( "Creating ROM cache %s ...", file_romcache ); }
+
+  if( jisho == NULL ){		/* 辞書ROM未使用でも、あれば格納しておく */
+    jisho_tmp = (byte *)malloc( romcache_block_size[ RC_JISHO ] );
+    if( jisho_tmp &&
+	load_rom( rom_list[ JISHO_ROM ], jisho_tmp,
+		  romcache_block_size[ RC_JISHO ], DISP_IF_EXIST )
+					== romcache_block_size[ RC_JISHO ] ){
+      jisho = jisho_tmp;
+    }
+  }
+
+		/* 他の QUASI88 がマップしているかもしれないので、上書きはせず、
+		   一時ファイルに書いてから置き換える */
+
+  if( strlen( file_romcache ) + 5 > sizeof(tmp) ){
+    if( verbose_proc ){ printf( "FAILED\n" ); }
+    if( jisho_tmp ) free( jisho_tmp );
+    return;
+  }
+  strcpy( tmp, file_romcache );
+  strcat( tmp, ".tmp" );
+
+  fp = osd_fopen( FTYPE_WRITE, tmp, "wb" );
+  if( fp == NULL ){
+    if( verbose_proc ){ printf( "FAILED\n" ); }
+    if( jisho_tmp ) free( jisho_tmp );
+    return;
+  }
+
+		/* ヘッダは、ハッシュが確定してから書き直す */
+
+  memset( &hdr, 0, sizeof(hdr) );
+  h = 2166136261u;
+  ok &= romcache_write( fp, NULL, ROMCACHE_PAGE, &h );
+
+  h = 2166136261u;
+  ok &= romcache_write( fp, main_rom,            0x8000, &h );
+  ok &= romcache_write( fp, &main_rom_ext[0][0], 0x8000, &h );
+  ok &= romcache_write( fp, main_rom_n,          0x8000, &h );
+  ok &= romcache_write( fp, sub_romram,          0x8000, &h );
+  ok &= romcache_write( fp, font_mem,            0x1000, &h );
+  ok &= romcache_write( fp, font_mem2,           0x1000, &h );
+  ok &= romcache_write( fp, font_mem3,           0x1000, &h );
+  ok &= romcache_write( fp, &kanji_rom[0][0][0], 0x40000, &h );
+  ok &= romcache_write( fp, jisho, romcache_block_size[ RC_JISHO ], &h );
+
+  memcpy( hdr.magic, ROMCACHE_MAGIC, sizeof(hdr.magic) );
+  hdr.version       = ROMCACHE_VERSION;
+  hdr.key           = romcache_key();
+  hdr.hash          = h;
+  hdr.size          = romcache_payload_size();
+  hdr.has_kanji_rom = has_kanji_rom;
+  hdr.has_jisho_rom = (jisho != NULL);
+  hdr.font_loaded   = font_loaded;
+
+  if( osd_fseek( fp, 0, SEEK_SET ) != 0 ||
+      osd_fwrite( &hdr, sizeof(hdr), 1, fp ) != 1 ){
+    ok = FALSE;
+  }
+  osd_fclose( fp );
+
+  if( ok ){
+    ok = osd_file_replace( tmp, file_romcache );
+  }else{
+    remove( tmp );
+  }
+
+  if( verbose_proc ){ printf( "%s\n", ok ? "OK" : "FAILED" ); }
+  if( jisho_tmp ) free( jisho_tmp );
+}
+
+
+
+/*
+ * ROMイメージをファイルから読み込む
+ */
+static	void	load_rom_files( void )
+{
+  int	size;
 
 
 		/* ROMイメージをファイルから読み込む */
@@ -404,12 +645,7 @@ int	memory_allocate( void )
 
   size=load_rom( rom_list[ KNJ1_ROM ], kanji_rom[0][0], 0x20000, DISP_RESULT );
 
-  if( size == 0x20000 ){
-    has_kanji_rom = TRUE;
-  }else{
-    has_kanji_rom = FALSE;
-    menu_lang = MENU_ENGLISH;
-  }
+  has_kanji_rom = ( size == 0x20000 ) ? TRUE : FALSE;
 
   load_rom( rom_list[ KNJ2_ROM ], kanji_rom[1][0], 0x20000, DISP_RESULT );
 
@@ -522,6 +758,58 @@ int	memory_allocate( void )
   memset( &font_mem[0],  0, 8 );
   memset( &font_mem2[0], 0, 8 );
   memset( &font_mem3[0], 0, 8 );
+}
+
+
+
+int	memory_allocate( void )
+{
+  int	cached;
+
+
+		/* 標準メモリを確保 */
+
+  mem_alloc_start( "Allocating memory for standard ROM/RAM..." );
+  {
+    main_rom     = (byte *)           mem_alloc( sizeof(byte) *  0x8000 );
+    main_rom_ext = (byte(*)[0x2000])  mem_alloc( sizeof(byte) *  0x2000 *4 );
+    main_rom_n   = (byte *)           mem_alloc( sizeof(byte) *  0x8000 );
+    sub_romram   = (byte *)           mem_alloc( sizeof(byte) *  0x8000 );
+
+    main_ram     = (byte *)           mem_alloc( sizeof(byte) * 0x10000 );
+    main_high_ram= (byte *)           mem_alloc( sizeof(byte) *  0x1000 );
+    main_vram    = (byte(*)[0x4])     mem_alloc( sizeof(byte) *  0x4000 *4 );
+
+    font_pcg     = (byte *)           mem_alloc( sizeof(byte)*8*256*2 );
+    font_mem     = (byte *)           mem_alloc( sizeof(byte)*8*256*2 );
+    font_mem2    = (byte *)           mem_alloc( sizeof(byte)*8*256*2 );
+    font_mem3    = (byte *)           mem_alloc( sizeof(byte)*8*256*2 );
+  }
+  if( mem_alloc_finish()==FALSE ){
+    return 0;
+  }
+
+
+		/* ROMキャッシュがあれば、ROMイメージはそこから取り出す */
+
+  cached = romcache_load();
+
+  if( cached == FALSE ){
+
+    mem_alloc_start( "Allocating memory for KANJI ROM..." );
+
+    kanji_rom    = (byte(*)[65536][2])mem_alloc( sizeof(byte)*2*65536*2 );
+
+    if( mem_alloc_finish()==FALSE ){
+      return 0;
+    }
+
+    load_rom_files();
+  }
+
+  if( has_kanji_rom == FALSE ){
+    menu_lang = MENU_ENGLISH;
+  }
 
 
   memory_reset_font();
@@ -537,6 +825,11 @@ int	memory_allocate( void )
     return 0;
   }
 
+		/* 次回の起動用に、ROMキャッシュを作成 */
+
+  if( cached == FALSE && file_romcache ){
+    romcache_save();
+  }
 
   return 1;
 }
@@ -547,8 +840,6 @@ int	memory_allocate( void )
  *
  *
  *****************************************************************************/
-static	int	alloced_extram = 0;		/* 確保した拡張RAMの数	*/
-
 int	memory_allocate_additional( void )
 {
 
@@ -565,7 +856,7 @@ int	memory_allocate_additional( void )
     }
 
 				/* 確保済みサイズが小さければ、確保しなおし */
-    if( ext_ram && alloced_extram < use_extram ){
+    if( ext_ram && machine->mem.ext_alloced < use_extram ){
       free( ext_ram );
       ext_ram = NULL;
     }
@@ -589,7 +880,7 @@ int	memory_allocate_additional( void )
 	return 0;
       }
 
-      alloced_extram = use_extram;
+      machine->mem.ext_alloced = use_extram;
     }
 
     memset( &ext_ram[0][0], 0xff, 0x8000 * 4*use_extram );
@@ -691,16 +982,25 @@ void	memory_free( void )
   if( main_high_ram )free( main_high_ram );
   if( main_vram )    free( main_vram );
 
-  if( kanji_rom )    free( kanji_rom );
+  if( kanji_rom && ! romcache_mapped( kanji_rom ) ) free( kanji_rom );
 
   if( font_pcg )     free( font_pcg );
   if( font_mem )     free( font_mem );
   if( font_mem2 )    free( font_mem2 );
   if( font_mem3 )    free( font_mem3 );
 
-  if( use_extram )    free( ext_ram );
-  if( use_jisho_rom ) free( jisho_rom );
+  if( ext_ram )      free( ext_ram );
+  if( jisho_rom && ! romcache_mapped( jisho_rom ) ) free( jisho_rom );
+  if( dummy_rom )    free( dummy_rom );
+  if( dummy_ram )    free( dummy_ram );
   if( sound_board==SOUND_II ) free( sound2_adpcm );
+
+  if( romcache_map ){			/* ROMキャッシュは最後にアンマップ */
+    osd_file_unmap( romcache_map, romcache_map_size );
+  }
+
+		/* 同じマシンで再確保できるよう、ポインタをクリアしておく */
+  memset( &machine->mem, 0, sizeof(machine->mem) );
 }
 
 
@@ -1,6 +1,8 @@
 #ifndef MEMORY_H_INCLUDED
 #define MEMORY_H_INCLUDED
 
+#include <stddef.h>			/* size_t */
+
 
 extern	int	set_version;	/* Сѹ '0'  '9'	*/
 extern	int	rom_version;	/* (ѹ) BASIC ROMС	*/
@@ -19,27 +21,61 @@ extern	char	*file_compatrom;		/* P88SR emu 
 
 extern	int	has_kanji_rom;			/* ROM̵ͭ	*/
 
+extern	char	*file_romcache;			/* ROMåե	*/
+
 extern	int	linear_ext_ram;			/* ĥRAMϢ³	*/
 
 
-extern	byte	*main_rom;			/* ᥤ ROM (32KB)	*/
-extern	byte	(*main_rom_ext)[0x2000];	/* ĥ ROM   (8KB *4)	*/
-extern	byte	*main_rom_n;			/* N-BASIC    (32KB)	*/
-extern	byte	*main_ram;			/* ᥤ RAM (64KB)	*/
-extern	byte	*main_high_ram;			/* ® RAM(΢) (4KB)	*/
-extern	byte	*sub_romram;			/*  ROM/RAM (32KB)	*/
+typedef	struct {			/* ޥΥ		*/
+
+  byte	*rom;				/* ᥤ ROM (32KB)	*/
+  byte	(*rom_ext)[0x2000];		/* ĥ ROM   (8KB *4)	*/
+  byte	*rom_n;				/* N-BASIC    (32KB)	*/
+  byte	*ram;				/* ᥤ RAM (64KB)	*/
+  byte	*high_ram;			/* ® RAM(΢) (4KB)	*/
+  byte	*sub_rom;			/*  ROM/RAM (32KB)	*/
+
+  byte	(*kanji)[65536][2];		/*  ROM   (128KB*2)	*/
+
+  byte	(*ext)[0x8000];			/* ĥ RAM   (32KB*4)*/
+  byte	(*jisho)[0x4000];		/*  ROM   (16KB*32)	*/
+
+  byte	(*vram)[4];			/* VRAM[0x4000][4]	*/
+  byte	*font;				/* եȥ᡼     */
+  byte	*pcg;				/* եȥ᡼(PCG)*/
+  byte	*font_fix;			/* եȥ᡼(fix)*/
+  byte	*font_2nd;			/* եȥ᡼(2nd)*/
+  byte	*font_3rd;			/* եȥ᡼(3rd)*/
+
+  byte	*rom_dummy;			/* ߡROM (32KB)	*/
+  byte	*ram_dummy;			/* ߡRAM (32KB)	*/
 
-extern	byte	(*kanji_rom)[65536][2];		/*  ROM   (128KB*2)	*/
+  int	ext_alloced;			/* ݤĥRAMο	*/
 
-extern	byte	(*ext_ram)[0x8000];		/* ĥ RAM   (32KB*4)*/
-extern	byte	(*jisho_rom)[0x4000];		/*  ROM   (16KB*32)	*/
+  void	*cache_map;			/* ޥåפROMå*/
+  size_t cache_map_size;
 
-extern	byte	(*main_vram)[4];		/* VRAM[0x4000][4]	*/
-extern	byte	*font_rom;			/* եȥ᡼     */
-extern	byte	*font_pcg;			/* եȥ᡼(PCG)*/
-extern	byte	*font_mem;			/* եȥ᡼(fix)*/
-extern	byte	*font_mem2;			/* եȥ᡼(2nd)*/
-extern	byte	*font_mem3;			/* եȥ᡼(3rd)*/
+} T_MEMORY;
+
+					/* ΥޥΥ	*/
+#define	main_rom	(machine->mem.rom)
+#define	main_rom_ext	(machine->mem.rom_ext)
+#define	main_rom_n	(machine->mem.rom_n)
+#define	main_ram	(machine->mem.ram)
+#define	main_high_ram	(machine->mem.high_ram)
+#define	sub_romram	(machine->mem.sub_rom)
+
+#define	kanji_rom	(machine->mem.kanji)
+
+#define	ext_ram		(machine->mem.ext)
+#define	jisho_rom	(machine->mem.jisho)
+
+#define	main_vram	(machine->mem.vram)
+#define	font_rom	(machine->mem.font)
+#define	font_pcg	(machine->mem.pcg)
+#define	font_mem	(machine->mem.font_fix)
+#define	font_mem2	(machine->mem.font_2nd)
+#define	font_mem3	(machine->mem.font_3rd)
 
 
 				/* ꡼ˡǥꥢ	*/
@@ -49,8 +85,8 @@ extern	byte	*font_mem3;			/* 
 
 
 
-extern	byte	*dummy_rom;			/* ߡROM (32KB)	*/
-extern	byte	*dummy_ram;			/* ߡRAM (32KB)	*/
+#define	dummy_rom	(machine->mem.rom_dummy)	/* ߡROM (32KB)	*/
+#define	dummy_ram	(machine->mem.ram_dummy)	/* ߡRAM (32KB)	*/
 extern	byte	kanji_dummy_rom[16][2];		/* ߡROM	*/
 
 
@@ -63,4 +99,7 @@ void	memory_set_font( void );
 
 int	memory_allocate_additional( void );
 
+
+#include "machine.h"
+
 #endif	/* MEMORY_H_INCLUDED */
@@ -1017,7 +1017,7 @@ enum SetType
   MTYPE_INT_C,		MTYPE_BYTE_C,	MTYPE_WORD_C,	MTYPE_DOUBLE_C,
   MTYPE_KEY,		MTYPE_PALETTE,	MTYPE_CRTC,	MTYPE_PIO,
   MTYPE_MEM,		MTYPE_FONT,	MTYPE_FRAMESKIP,MTYPE_INTERLACE,
-  MTYPE_INTERP,		MTYPE_CLOCK,	MTYPE_BEEP,
+  MTYPE_INTERP,		MTYPE_CLOCK,	MTYPE_BEEP,	MTYPE_ALU,
   MTYPE_VOLUME,		MTYPE_FMMIXER,	MTYPE_PSGMIXER,	MTYPE_BEEPMIXER,
   MTYPE_RHYTHMMIXER,	MTYPE_ADPCMMIXER,	MTYPE_FMGENMIXER,
   MTYPE_SAMPLEMIXER,	MTYPE_MIXER,
@@ -1042,15 +1042,15 @@ static struct {
 { "sys_ctrl",		"(OUT:30)",	MTYPE_BYTE_C,	&sys_ctrl,	    },
 { "grph_ctrl",		"(OUT:31)",	MTYPE_BYTE_C,	&grph_ctrl,	    },
 { "misc_ctrl",		"(I/O:32)",	MTYPE_BYTE_C,	&misc_ctrl,	    },
-{ "ALU1_ctrl",		"(OUT:34)",	MTYPE_BYTE,	&ALU1_ctrl,	    },
+{ "ALU1_ctrl",		"(OUT:34)",	MTYPE_ALU,	&ALU1_ctrl,	    },
 { "ALU2_ctrl",		"(OUT:35)",	MTYPE_BYTE_C,	&ALU2_ctrl,	    },
 { "ctrl_signal",	"(OUT:40)",	MTYPE_BYTE_C,	&ctrl_signal,	    },
 { "grph_pile",		"(OUT:53)",	MTYPE_BYTE_C,	&grph_pile,	    },
-{ "intr_level",		"(OUT:E4&07)",	MTYPE_INT_C,	&intr_level,	    },
-{ "intr_priority",	"(OUT:E4&08)",	MTYPE_INT_C,	&intr_priority,	    },
-{ "intr_sio_enable",	"(OUT:E6&04)",	MTYPE_INT_C,	&intr_sio_enable,   },
-{ "intr_vsync_enable",	"(OUT:E6&02)",	MTYPE_INT_C,	&intr_vsync_enable, },
-{ "intr_rtc_enable",	"(OUT:E6&01)",	MTYPE_INT_C,	&intr_rtc_enable,   },
+{ "intr_level",		"(OUT:E4&07)",	MTYPE_INT_C,	&machine_0.intr.level, },
+{ "intr_priority",	"(OUT:E4&08)",	MTYPE_INT_C,	&machine_0.intr.priority, },
+{ "intr_sio_enable",	"(OUT:E6&04)",	MTYPE_INT_C,	&machine_0.intr.sio_enable, },
+{ "intr_vsync_enable",	"(OUT:E6&02)",	MTYPE_INT_C,	&machine_0.intr.vsync_enable, },
+{ "intr_rtc_enable",	"(OUT:E6&01)",	MTYPE_INT_C,	&machine_0.intr.rtc_enable, },
 { "intr_sound_enable",	"(IO:~32AA&80)",MTYPE_INT_C,	&intr_sound_enable, },
 { "sound_ENABLE_A",	"(sd[27])",	MTYPE_INT,	&sound_ENABLE_A,    },
 { "sound_ENABLE_B",	"(sd[27])",	MTYPE_INT,	&sound_ENABLE_B,    },
@@ -1067,11 +1067,11 @@ static struct {
 { "sound2_EN_ZERO",	"(sd[29])",	MTYPE_INT,	&sound2_EN_ZERO,    },
 { "use_cmdsing",	"",		MTYPE_BEEP,	&use_cmdsing,	    },
 { "",			"",		MTYPE_NEWLINE,	NULL,		    },
-{ "RS232C_flag",	"",		MTYPE_INT,	&RS232C_flag,	    },
-{ "VSYNC_flag",		"",		MTYPE_INT,	&VSYNC_flag,	    },
-{ "ctrl_vrtc",		"",		MTYPE_INT,	&ctrl_vrtc,	    },
-{ "RTC_flag",		"",		MTYPE_INT,	&RTC_flag,	    },
-{ "SOUND_flag",		"",		MTYPE_INT,	&SOUND_flag,	    },
+{ "RS232C_flag",	"",		MTYPE_INT,	&machine_0.intr.rs232c_flag, },
+{ "VSYNC_flag",		"",		MTYPE_INT,	&machine_0.intr.vsync_flag, },
+{ "ctrl_vrtc",		"",		MTYPE_INT,	&machine_0.intr.vrtc, },
+{ "RTC_flag",		"",		MTYPE_INT,	&machine_0.intr.rtc_flag, },
+{ "SOUND_flag",		"",		MTYPE_INT,	&machine_0.intr.sound_flag, },
 { "",			"",		MTYPE_NEWLINE,	NULL,		    },
 
 { "mem",		"",		MTYPE_MEM,	NULL,		    },
@@ -3473,6 +3473,7 @@ static	void	monitor_set_samplemixer(int vol)
 static	void	monitor_set_show_printf(int index)	/*** set (print) ***/
 {
     int val;
+    void *var_ptr = machine_relocate(monitor_variable[index].var_ptr);
 
     switch (monitor_variable[index].var_type) {
 
@@ -3483,17 +3484,18 @@ static	void	monitor_set_show_printf(int index)	/*** set (print) ***/
     case MTYPE_INTERLACE:
     case MTYPE_INTERP:
     case MTYPE_BEEP:
-	val = *((int *)monitor_variable[index].var_ptr);
+	val = *((int *)var_ptr);
 	goto MTYPE_numeric_variable;
 
     case MTYPE_BYTE:
     case MTYPE_BYTE_C:
-	val = *((byte *)monitor_variable[index].var_ptr);
+    case MTYPE_ALU:
+	val = *((byte *)var_ptr);
 	goto MTYPE_numeric_variable;
 
     case MTYPE_WORD:
     case MTYPE_WORD_C:
-	val = *((word *)monitor_variable[index].var_ptr);
+	val = *((word *)var_ptr);
 	goto MTYPE_numeric_variable;
 
     MTYPE_numeric_variable:;
@@ -3508,7 +3510,7 @@ static	void	monitor_set_show_printf(int index)	/*** set (print) ***/
 	printf("  %-23s %-15s %8.4f\n",
 	       monitor_variable[index].var_name,
 	       monitor_variable[index].port_mes,
-	       *((double *)monitor_variable[index].var_ptr));
+	       *((double *)var_ptr));
 	break;
 
     case MTYPE_MEM:
@@ -3653,7 +3655,7 @@ static	void	monitor_set(void)
 	break;
 
     case 2:
-	var_ptr = monitor_variable[index].var_ptr;
+	var_ptr = machine_relocate(monitor_variable[index].var_ptr);
 	switch (monitor_variable[index].var_type) {
 
 	case MTYPE_INT_C:
@@ -3690,6 +3692,11 @@ static	void	monitor_set(void)
 	    interval_work_init_all();
 	    break;
 
+	case MTYPE_ALU:
+	    *((byte *)var_ptr) = value;
+	    set_ALU_ope();
+	    break;
+
 	case MTYPE_BEEP:
 	    *((int *)var_ptr) = value;
 #ifdef	USE_SOUND
@@ -5,8 +5,11 @@
 #include  "z80.h"
 
 
-extern	z80arch	z80main_cpu;		/* ᥤ CPU	*/
-extern	z80arch	z80sub_cpu;		/*  CPU	*/
+#include  "machine.h"
+
+					/* Υޥ CPU	*/
+#define	z80main_cpu	(machine->main_cpu)	/* ᥤ CPU	*/
+#define	z80sub_cpu	(machine->sub_cpu)	/*  CPU	*/
 
 
 #endif	/* PC88CPU_H_INCLUDED */
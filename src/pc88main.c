@@ -29,6 +29,7 @@
 #include "snddrv.h"
 #include "suspend.h"
 #include "status.h"
+#include "stats.h"
 
 
 
@@ -48,7 +49,7 @@ int	boot_clock_4mhz=DEFAULT_CLOCK;	/* 起動時の CPUクロック		*/
 
 int	monitor_15k    =0x00;		/* 15k モニター 2:Yes 0:No	*/
 
-z80arch	z80main_cpu;			/* Z80 CPU ( main system )	*/
+/* Z80 CPU ( main system ) は machine->main_cpu (pc88cpu.h 参照) */
 
 int	high_mode;			/* 高速モード 1:Yes 0:No	*/
 
@@ -510,6 +511,7 @@ INLINE	byte	vram_read( word addr )
 /*------------------------------*/
 INLINE	void	vram_write( word addr, byte data )
 {
+  STATS_INC( STATS_VRAM_WRITE );
   screen_set_dirty_flag(addr);
 
   main_vram[addr][ memory_bank ] = data;
@@ -526,72 +528,120 @@ typedef	union {
 static	ALU_memory	ALU_buf;
 static	ALU_memory	ALU_comp;
 
+/* ALU ライト用の演算マスク。 port 34H/35H の OUT 時に作り直す。
+	ALU_and	… 書き込みデータでビットを落とすプレーン
+	ALU_xor	… 書き込みデータでビットを反転するプレーン
+	ALU_cpy	… ALU_buf からの転送先プレーン
+	ALU_shr, ALU_shl … 転送時の ALU_buf のプレーン位置合わせ	*/
+static	bit32		ALU_and;
+static	bit32		ALU_xor;
+static	bit32		ALU_cpy;
+static	int		ALU_shr;
+static	int		ALU_shl;
+
 #ifdef LSB_FIRST
-#define	set_ALU_comp()						\
-	do{							\
-	  ALU_comp.l = 0;					\
-	  if( (ALU2_ctrl&0x01)==0 ) ALU_comp.l |= 0x000000ff;	\
-	  if( (ALU2_ctrl&0x02)==0 ) ALU_comp.l |= 0x0000ff00;	\
-	  if( (ALU2_ctrl&0x04)==0 ) ALU_comp.l |= 0x00ff0000;	\
-	}while(0)
+#define	ALU_PLANE(i)	((bit32)0x000000ff << ((i)*8))
 #else
+#define	ALU_PLANE(i)	((bit32)0xff000000 >> ((i)*8))
+#endif
+#define	ALU_PAD		ALU_PLANE(3)
+
 #define	set_ALU_comp()						\
 	do{							\
 	  ALU_comp.l = 0;					\
-	  if( (ALU2_ctrl&0x01)==0 ) ALU_comp.l |= 0xff000000;	\
-	  if( (ALU2_ctrl&0x02)==0 ) ALU_comp.l |= 0x00ff0000;	\
-	  if( (ALU2_ctrl&0x04)==0 ) ALU_comp.l |= 0x0000ff00;	\
+	  if( (ALU2_ctrl&0x01)==0 ) ALU_comp.l |= ALU_PLANE(0);	\
+	  if( (ALU2_ctrl&0x02)==0 ) ALU_comp.l |= ALU_PLANE(1);	\
+	  if( (ALU2_ctrl&0x04)==0 ) ALU_comp.l |= ALU_PLANE(2);	\
 	}while(0)
-#endif
-
-INLINE	byte	ALU_read( word addr )
-{
-  ALU_memory	wk;
-
-  ALU_buf.l  = (main_vram4)[addr];
-  wk.l       = ALU_comp.l ^ ALU_buf.l;
-
-  return  wk.c[0] & wk.c[1] & wk.c[2];
-}
 
-/*------------------------------*/
-/* ＡＬＵを介したＶＲＡＭライト	*/
-/*------------------------------*/
-INLINE	void	ALU_write( word addr, byte data )
+/*
+ * ALU1_ctrl, ALU2_ctrl から、ALU ライトの演算マスクを求める
+ *	ライト時は、プレーン毎に
+ *		new = ( old & ~(data & ALU_and) & ~ALU_cpy )
+ *			^ (data & ALU_xor) ^ (ALU_buf & ALU_cpy)
+ *	を 32bit 一括で処理する。(data は全プレーンに複写した値)
+ *
+ *			ALU_and	ALU_xor
+ *	リセット	  1	  0	( old & ~data )
+ *	セット		  1	  1	( old |  data )
+ *	反転		  0	  1	( old ^  data )
+ *	変化なし	  0	  0
+ */
+void	set_ALU_ope( void )
 {
   int i, mode;
 
-  screen_set_dirty_flag(addr);
+  ALU_and = ALU_xor = ALU_cpy = 0;
+  ALU_shr = ALU_shl = 0;
 
   switch( ALU2_ctrl&ALU2_CTRL_MODE ){
 
-  case 0x00:
+  case 0x00:				/* ALU1_ctrl による論理演算 */
     mode = ALU1_ctrl;
     for( i=0;  i<3;  i++, mode>>=1 ){
       switch( mode&0x11 ){
-      case 0x00:  main_vram[addr][i] &= ~data;	break;
-      case 0x01:  main_vram[addr][i] |=  data;	break;
-      case 0x10:  main_vram[addr][i] ^=  data;	break;
-      default:					break;
+      case 0x00:  ALU_and |= ALU_PLANE(i);				break;
+      case 0x01:  ALU_and |= ALU_PLANE(i);  ALU_xor |= ALU_PLANE(i);	break;
+      case 0x10:                            ALU_xor |= ALU_PLANE(i);	break;
+      default:								break;
       }
     }
     break;
 
-  case 0x10:
-    (main_vram4)[addr] = ALU_buf.l;
+  case 0x10:				/* 全プレーン転送 */
+    ALU_cpy = 0xffffffff;
     break;
 
-  case 0x20:
-    main_vram[addr][0] = ALU_buf.c[1];
+  case 0x20:				/* R → B プレーン転送 */
+    ALU_cpy = ALU_PLANE(0);
+#ifdef LSB_FIRST
+    ALU_shr = 8;
+#else
+    ALU_shl = 8;
+#endif
     break;
 
-  default:
-    main_vram[addr][1] = ALU_buf.c[0];
+  default:				/* B → R プレーン転送 */
+    ALU_cpy = ALU_PLANE(1);
+#ifdef LSB_FIRST
+    ALU_shl = 8;
+#else
+    ALU_shr = 8;
+#endif
     break;
 
   }
 }
 
+INLINE	byte	ALU_read( word addr )
+{
+  bit32	wk;
+
+  ALU_buf.l  = (main_vram4)[addr];
+
+  /* 3 プレーンの比較結果の AND を最下位バイトに畳み込む */
+  wk  = (ALU_comp.l ^ ALU_buf.l) | ALU_PAD;
+  wk &= wk >> 16;
+  wk &= wk >> 8;
+
+  return  (byte)wk;
+}
+
+/*------------------------------*/
+/* ＡＬＵを介したＶＲＡＭライト	*/
+/*------------------------------*/
+INLINE	void	ALU_write( word addr, byte data )
+{
+  bit32	d = (bit32)data * 0x01010101;
+  bit32	s = (ALU_buf.l >> ALU_shr) << ALU_shl;
+
+  STATS_INC( STATS_ALU_WRITE );
+  screen_set_dirty_flag(addr);
+
+  (main_vram4)[addr] = (((main_vram4)[addr] & ~((d & ALU_and) | ALU_cpy))
+			^ (d & ALU_xor)) ^ (s & ALU_cpy);
+}
+
 
 /*----------------------*/
 /*    フェッチ		*/
@@ -680,9 +730,13 @@ byte	main_fetch( word addr )
 /*----------------------*/
 byte	main_mem_read( word addr )
 {
-  if     ( addr < 0x6000 ) return  read_mem_0000_5fff[ addr ];
-  else if( addr < 0x8000 ) return  read_mem_6000_7fff[ addr & 0x1fff ];
+  if( addr < 0x8000 ){
+    STATS_INC( STATS_MAIN_READ_0000 );
+    if   ( addr < 0x6000 ) return  read_mem_0000_5fff[ addr ];
+    else                   return  read_mem_6000_7fff[ addr & 0x1fff ];
+  }
   else if( addr < 0x8400 ){
+    STATS_INC( STATS_MAIN_READ_8000 );
     if( read_mem_8000_83ff ) return  read_mem_8000_83ff[ addr & 0x03ff ];
     else{
       addr = (addr & 0x03ff) + window_offset;
@@ -690,8 +744,12 @@ byte	main_mem_read( word addr )
       else                return  main_high_ram[ addr & 0x0fff ];
     }
   }
-  else if( addr < 0xc000 ) return  main_ram[ addr ];
+  else if( addr < 0xc000 ){
+    STATS_INC( STATS_MAIN_READ_8400 );
+    return  main_ram[ addr ];
+  }
   else{
+    STATS_INC( STATS_MAIN_READ_C000 );
     switch( vram_access_way ){
     case VRAM_ACCESS_ALU:  return  ALU_read(  addr & 0x3fff );
     case VRAM_ACCESS_BANK: return  vram_read( addr & 0x3fff );
@@ -707,8 +765,12 @@ byte	main_mem_read( word addr )
 /*----------------------*/
 void	main_mem_write( word addr, byte data )
 {
-  if     ( addr < 0x8000 ) write_mem_0000_7fff[ addr ]          = data;
+  if     ( addr < 0x8000 ){
+    STATS_INC( STATS_MAIN_WRITE_0000 );
+    write_mem_0000_7fff[ addr ]          = data;
+  }
   else if( addr < 0x8400 ){
+    STATS_INC( STATS_MAIN_WRITE_8000 );
     if( write_mem_8000_83ff ) write_mem_8000_83ff[ addr & 0x03ff ] = data;
     else{
       addr = (addr & 0x03ff) + window_offset;
@@ -716,8 +778,12 @@ void	main_mem_write( word addr, byte data )
       else                main_high_ram[ addr & 0x0fff ] = data;
     }
   }
-  else if( addr < 0xc000 ) main_ram[ addr ]                     = data;
+  else if( addr < 0xc000 ){
+    STATS_INC( STATS_MAIN_WRITE_8400 );
+    main_ram[ addr ]                     = data;
+  }
   else{
+    STATS_INC( STATS_MAIN_WRITE_C000 );
     switch( vram_access_way ){
     case VRAM_ACCESS_ALU:  ALU_write( addr & 0x3fff, data );	break;
     case VRAM_ACCESS_BANK: vram_write( addr & 0x3fff, data );	break;
@@ -859,10 +925,12 @@ printf("CMT %02x, %s: Motor %s: CDS %d\n",data,
 	/* 拡張VRAM制御 */
   case 0x34:
     ALU1_ctrl = data;
+    set_ALU_ope();
     return;
   case 0x35:
     ALU2_ctrl = data;
     set_ALU_comp();
+    set_ALU_ope();
 
     /* クリムゾン３やワードラゴン,STAR TRADERなどで使用 */
     if (data & ALU2_CTRL_VACCESS) memory_bank = MEMORY_BANK_MAIN;
@@ -2732,6 +2800,7 @@ void	pc88main_init( int init )
 
   z80main_cpu.intr_update = main_INT_update;
   z80main_cpu.intr_ack    = main_INT_chk;
+  z80main_cpu.stats_insn  = STATS_MAIN_INSN;
 
   z80main_cpu.break_if_halt = FALSE;		/* for debug */
   z80main_cpu.PC_prev   = z80main_cpu.PC;	/* dummy for monitor */
@@ -2855,6 +2924,7 @@ void	pc88main_init( int init )
   main_memory_mapping_8000_83ff();
   main_memory_mapping_c000_ffff();
   main_memory_vram_mapping();
+  set_ALU_ope();
 
 
   /* CRTC/DMAC関連による初期化 */
@@ -3021,31 +3091,31 @@ static	T_SUSPEND_W	suspend_pc88main_work[]=
   { TYPE_INT,	&boot_clock_4mhz,	},
   { TYPE_INT,	&monitor_15k,		},
 
-  { TYPE_PAIR,	&z80main_cpu.AF,	},
-  { TYPE_PAIR,	&z80main_cpu.BC,	},
-  { TYPE_PAIR,	&z80main_cpu.DE,	},
-  { TYPE_PAIR,	&z80main_cpu.HL,	},
-  { TYPE_PAIR,	&z80main_cpu.IX,	},
-  { TYPE_PAIR,	&z80main_cpu.IY,	},
-  { TYPE_PAIR,	&z80main_cpu.PC,	},
-  { TYPE_PAIR,	&z80main_cpu.SP,	},
-  { TYPE_PAIR,	&z80main_cpu.AF1,	},
-  { TYPE_PAIR,	&z80main_cpu.BC1,	},
-  { TYPE_PAIR,	&z80main_cpu.DE1,	},
-  { TYPE_PAIR,	&z80main_cpu.HL1,	},
-  { TYPE_BYTE,	&z80main_cpu.I,		},
-  { TYPE_BYTE,	&z80main_cpu.R,		},
-  { TYPE_BYTE,	&z80main_cpu.R_saved,	},
-  { TYPE_CHAR,	&z80main_cpu.IFF,	},
-  { TYPE_CHAR,	&z80main_cpu.IFF2,	},
-  { TYPE_CHAR,	&z80main_cpu.IM,	},
-  { TYPE_CHAR,	&z80main_cpu.HALT,	},
-  { TYPE_INT,	&z80main_cpu.INT_active,},
-  { TYPE_INT,	&z80main_cpu.icount,	},
-  { TYPE_INT,	&z80main_cpu.state0,	},
-  { TYPE_INT,	&z80main_cpu.skip_intr_chk,	},
-  { TYPE_CHAR,	&z80main_cpu.log,		},
-  { TYPE_CHAR,	&z80main_cpu.break_if_halt,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.AF,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.BC,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.DE,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.HL,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.IX,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.IY,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.PC,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.SP,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.AF1,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.BC1,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.DE1,	},
+  { TYPE_PAIR,	&machine_0.main_cpu.HL1,	},
+  { TYPE_BYTE,	&machine_0.main_cpu.I,	},
+  { TYPE_BYTE,	&machine_0.main_cpu.R,	},
+  { TYPE_BYTE,	&machine_0.main_cpu.R_saved,	},
+  { TYPE_CHAR,	&machine_0.main_cpu.IFF,	},
+  { TYPE_CHAR,	&machine_0.main_cpu.IFF2,	},
+  { TYPE_CHAR,	&machine_0.main_cpu.IM,	},
+  { TYPE_CHAR,	&machine_0.main_cpu.HALT,	},
+  { TYPE_INT,	&machine_0.main_cpu.INT_active,	},
+  { TYPE_INT,	&machine_0.main_cpu.icount,	},
+  { TYPE_INT,	&machine_0.main_cpu.state0,	},
+  { TYPE_INT,	&machine_0.main_cpu.skip_intr_chk,	},
+  { TYPE_CHAR,	&machine_0.main_cpu.log,	},
+  { TYPE_CHAR,	&machine_0.main_cpu.break_if_halt,	},
 
   { TYPE_INT,	&high_mode,		},
 
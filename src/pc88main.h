@@ -124,6 +124,7 @@ void	pc88main_init( int init );
 void	pc88main_term( void );
 void	pc88main_bus_setup( void );
 void	power_on_ram_init( void );
+void	set_ALU_ope( void );
 
 byte	main_mem_read( word addr );
 void	main_mem_write( word addr, byte data );
@@ -19,10 +19,10 @@
 
 #include "emu.h"
 #include "suspend.h"
+#include "stats.h"
 
 
-
-z80arch	z80sub_cpu;			/* Z80 CPU ( sub system )	*/
+/* Z80 CPU ( sub system ) は machine->sub_cpu (pc88cpu.h 参照) */
 
 int	sub_load_rate = 6;		/*				*/
 
@@ -292,6 +292,7 @@ void	pc88sub_init( int init )
 
   z80sub_cpu.intr_update = sub_INT_update;
   z80sub_cpu.intr_ack    = sub_INT_chk;
+  z80sub_cpu.stats_insn  = STATS_SUB_INSN;
 
   z80sub_cpu.break_if_halt = TRUE;
   z80sub_cpu.PC_prev   = z80sub_cpu.PC;		/* dummy for monitor */
@@ -452,31 +453,31 @@ void	pc88sub_bus_setup( void )
 
 static	T_SUSPEND_W	suspend_pc88sub_work[]=
 {
-  { TYPE_PAIR,	&z80sub_cpu.AF,		},
-  { TYPE_PAIR,	&z80sub_cpu.BC,		},
-  { TYPE_PAIR,	&z80sub_cpu.DE,		},
-  { TYPE_PAIR,	&z80sub_cpu.HL,		},
-  { TYPE_PAIR,	&z80sub_cpu.IX,		},
-  { TYPE_PAIR,	&z80sub_cpu.IY,		},
-  { TYPE_PAIR,	&z80sub_cpu.PC,		},
-  { TYPE_PAIR,	&z80sub_cpu.SP,		},
-  { TYPE_PAIR,	&z80sub_cpu.AF1,	},
-  { TYPE_PAIR,	&z80sub_cpu.BC1,	},
-  { TYPE_PAIR,	&z80sub_cpu.DE1,	},
-  { TYPE_PAIR,	&z80sub_cpu.HL1,	},
-  { TYPE_BYTE,	&z80sub_cpu.I,		},
-  { TYPE_BYTE,	&z80sub_cpu.R,		},
-  { TYPE_BYTE,	&z80sub_cpu.R_saved,	},
-  { TYPE_CHAR,	&z80sub_cpu.IFF,	},
-  { TYPE_CHAR,	&z80sub_cpu.IFF2,	},
-  { TYPE_CHAR,	&z80sub_cpu.IM,		},
-  { TYPE_CHAR,	&z80sub_cpu.HALT,	},
-  { TYPE_INT,	&z80sub_cpu.INT_active,	},
-  { TYPE_INT,	&z80sub_cpu.icount,	},
-  { TYPE_INT,	&z80sub_cpu.state0,	},
-  { TYPE_INT,	&z80sub_cpu.skip_intr_chk,	},
-  { TYPE_CHAR,	&z80sub_cpu.log,		},
-  { TYPE_CHAR,	&z80sub_cpu.break_if_halt,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.AF,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.BC,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.DE,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.HL,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.IX,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.IY,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.PC,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.SP,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.AF1,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.BC1,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.DE1,	},
+  { TYPE_PAIR,	&machine_0.sub_cpu.HL1,	},
+  { TYPE_BYTE,	&machine_0.sub_cpu.I,	},
+  { TYPE_BYTE,	&machine_0.sub_cpu.R,	},
+  { TYPE_BYTE,	&machine_0.sub_cpu.R_saved,	},
+  { TYPE_CHAR,	&machine_0.sub_cpu.IFF,	},
+  { TYPE_CHAR,	&machine_0.sub_cpu.IFF2,	},
+  { TYPE_CHAR,	&machine_0.sub_cpu.IM,	},
+  { TYPE_CHAR,	&machine_0.sub_cpu.HALT,	},
+  { TYPE_INT,	&machine_0.sub_cpu.INT_active,	},
+  { TYPE_INT,	&machine_0.sub_cpu.icount,	},
+  { TYPE_INT,	&machine_0.sub_cpu.state0,	},
+  { TYPE_INT,	&machine_0.sub_cpu.skip_intr_chk,	},
+  { TYPE_CHAR,	&machine_0.sub_cpu.log,	},
+  { TYPE_CHAR,	&machine_0.sub_cpu.break_if_halt,	},
 
   { TYPE_INT,	&sub_load_rate,		},
 
@@ -59,8 +59,6 @@
 pio_work	pio_AB[2][2], pio_C[2][2];
 
 
-static	z80arch	*z80[2] = { &z80main_cpu, &z80sub_cpu };
-
 
 
 
@@ -124,6 +124,9 @@ static	int	now_mouse_on;
 
 static	void	widget_map(Q8tkWidget *widget);
 static	void	widget_construct(void);
+static	void	widget_damage(Q8tkWidget *widget);
+static	void	widget_damage_cancel(Q8tkWidget *widget);
+static	void	widget_redraw(void);
 static	void	widget_signal_do(Q8tkWidget *widget, const char *name);
 
 
@@ -182,6 +185,13 @@ static	Q8tkWidget	*malloc_widget(void)
 static	void	free_widget(Q8tkWidget *w)
 {
     int i;
+    for (i=0; i<MAX_WINDOW_LAYER; i++) {	/* 部分描画の際に参照するので */
+	if (focus_widget[i] == w) {		/* 消去したものは外しておく   */
+	    focus_widget[i] = NULL;
+	}
+    }
+    widget_damage_cancel(w);
+
     for (i=0; i<MAX_WIDGET; i++) {
 	if (widget_table[i] == w) {
 	    free(w);
@@ -433,6 +443,14 @@ static	int		q8tk_construct_flag;
 #define	set_construct_flag(f)	q8tk_construct_flag = (f)
 #define	get_construct_flag()	q8tk_construct_flag
 
+/* 画面構築をせずに、そのウィジットだけを描画しなおす (ダメージリスト) */
+#define	MAX_WIDGET_DAMAGE	(16)
+static	Q8tkWidget	*widget_damage_list[ MAX_WIDGET_DAMAGE ];
+static	int		widget_damage_nr;
+static	int		widget_damage_mouse;	/* マウスカーソル移動	*/
+static	int		widget_construct_serial;/* 画面構築の通し番号	*/
+static	int		widget_redrawing;	/* 部分描画中なら真	*/
+
 
 static	Q8tkWidget	*q8tk_drag_widget;
 #define	set_drag_widget(w)	q8tk_drag_widget = (w)
@@ -487,6 +505,8 @@ void	q8tk_init(void)
 
     set_main_loop_flag(TRUE);
     set_construct_flag(FALSE);
+    widget_damage_nr    = 0;
+    widget_damage_mouse = FALSE;
 
     set_drag_widget(NULL);
     widget_focus_list_init();
@@ -687,7 +707,7 @@ static	void	button_event_key_on(Q8tkWidget *widget, int key)
 
 #else		/* 凹んだ状態を描画させたいので、イベントを遅らせる */
 	widget->stat.button.active = Q8TK_BUTTON_ON;
-	set_construct_flag(TRUE);
+	widget_damage(widget);
 	set_delay_widget(widget, 3);		/* 3 フレーム分遅延 */
 #endif
     }
@@ -699,7 +719,7 @@ static	void	button_event_button_on(Q8tkWidget *widget)
     set_drag_widget(widget);
 
     widget->stat.button.active = Q8TK_BUTTON_ON;
-    set_construct_flag(TRUE);
+    widget_damage(widget);
 }
 
 /* ドラッグ中は、マウスの位置に応じて、ボタンを凸凹させる */
@@ -708,12 +728,12 @@ static	void	button_event_dragging(Q8tkWidget *widget)
     if (q8gr_get_focus_screen(mouse.x/8, mouse.y/16) == widget) {
 	if (widget->stat.button.active == Q8TK_BUTTON_OFF) {
 	    widget->stat.button.active = Q8TK_BUTTON_ON;
-	    set_construct_flag(TRUE);
+	    widget_damage(widget);
 	}
     } else {
 	if (widget->stat.button.active == Q8TK_BUTTON_ON) {
 	    widget->stat.button.active = Q8TK_BUTTON_OFF;
-	    set_construct_flag(TRUE);
+	    widget_damage(widget);
 	}
     }
 }
@@ -731,7 +751,7 @@ static	void	button_event_drag_off(Q8tkWidget *widget)
 #else	/* イベントを遅らせることで、連続表示しないようにする */
 	widget->stat.button.active = Q8TK_BUTTON_OFF;
 	set_delay_widget(widget, 3);		/* 3 フレーム分遅延 */
-	set_construct_flag(TRUE);
+	widget_damage(widget);
 #endif
     }
 }
@@ -856,7 +876,7 @@ void		q8tk_toggle_button_set_state(Q8tkWidget *widget, int status)
 	}
     } else {
 	widget->stat.button.active = Q8TK_BUTTON_OFF;
-	set_construct_flag(TRUE);
+	widget_damage(widget);
     }
 }
 
@@ -915,7 +935,7 @@ static	void	check_button_event_key_on(Q8tkWidget *widget, int key)
 static	void	check_button_event_button_on(Q8tkWidget *widget)
 {
     set_drag_widget(widget);
-    set_construct_flag(TRUE);
+    widget_damage(widget);
 }
 
 /* ドラッグ終了で、シグナル発生 (ドラッグ中は、なにもしない) */
@@ -2079,7 +2099,7 @@ void		q8tk_label_set_reverse(Q8tkWidget *w, int reverse)
 {
     if (w->stat.label.reverse != reverse) {
 	w->stat.label.reverse = reverse;
-	set_construct_flag(TRUE);
+	widget_damage(w);
     }
 }
 void		q8tk_label_set_color(Q8tkWidget *w, int foreground)
@@ -2088,7 +2108,7 @@ void		q8tk_label_set_color(Q8tkWidget *w, int foreground)
 
     if (w->stat.label.foreground != foreground) {
 	w->stat.label.foreground = foreground;
-	set_construct_flag(TRUE);
+	widget_damage(w);
     }
 }
 
@@ -3243,7 +3263,7 @@ static	void	entry_event_button_on(Q8tkWidget *widget)
 	q8tk_entry_set_position(widget,		
 				m_x - widget->x + widget->stat.entry.disp_pos);
     }
-    set_construct_flag(TRUE);
+    widget_damage(widget);
 }
 
 /* ←→↑↓キーを押したら、カーソル移動           (編集可能時のみ) */
@@ -3344,7 +3364,7 @@ static	void	entry_event_key_on(Q8tkWidget *widget, int key)
 	    q8gr_strdel(widget->code, widget->name,
 			widget->stat.entry.cursor_pos);
 	    /* カーソルの移動は不要 */
-	    set_construct_flag(TRUE);
+	    widget_damage(widget);
 	    widget_signal_do(widget, "changed");
 	}
 	break;
@@ -3441,7 +3461,7 @@ void		q8tk_entry_set_position(Q8tkWidget *entry, int position)
 
     if (position < 0) {
 	entry->stat.entry.cursor_pos = -1;
-	set_construct_flag(TRUE);
+	widget_damage(entry);
 	return;
     }
 
@@ -3485,7 +3505,7 @@ void		q8tk_entry_set_position(Q8tkWidget *entry, int position)
 
     }
     q8gr_set_cursor_blink();
-    set_construct_flag(TRUE);
+    widget_damage(entry);
 }
 
 void		q8tk_entry_set_max_length(Q8tkWidget *entry, int max)
@@ -5055,8 +5075,18 @@ static	void	widget_destroy_all(Q8tkWidget *widget)
 /************************************************************************/
 void	q8tk_widget_set_focus(Q8tkWidget *widget)
 {
+    Q8tkWidget *old = focus_widget[ window_layer_level ];
+
     focus_widget[ window_layer_level ] = widget;
-    set_construct_flag(TRUE);
+
+    if (old && widget) {	/* フォーカスの表示が変わるものだけ描画 */
+	widget_damage(old);
+	if (old != widget) {
+	    widget_damage(widget);
+	}
+    } else {
+	set_construct_flag(TRUE);
+    }
 }
 
 
@@ -5504,7 +5534,7 @@ void	q8tk_event_mouse_moved(int x, int y)
 	now_mouse_on = FALSE;
 
 	if (disp_cursor) {
-	    set_construct_flag(TRUE);
+	    widget_damage_mouse = TRUE;
 	}
     } else {
 	block_moved = FALSE;
@@ -5591,7 +5621,7 @@ int	q8tk_main_loop(void)
 	    if (cursor_exist) {		  /* カーソル点滅切り替わりの	*/
 		if (cursor_timer == 0 ||  /* タイミングをチェック	*/
 		    cursor_timer == Q8GR_CURSOR_BLINK) {
-		    set_construct_flag(TRUE);
+		    widget_damage(get_focus_widget());
 		}
 	    }
 
@@ -5618,6 +5648,10 @@ int	q8tk_main_loop(void)
 
 
 
+	if (get_construct_flag() == FALSE) {	/* 状態が変わっただけなら */
+	    widget_redraw();			/* そのウィジットのみ描画 */
+	}				/* (描画できなければ、画面構築) */
+
 	if (get_construct_flag()) {	/* 画面構成変更時は、描画 */
 
 	    widget_construct();
@@ -6337,7 +6371,7 @@ static	void	widget_focus_list_reset(void)
 /* 設定：フォーカスリストに登録するウィジットなら、呼び出す */
 static	void	widget_focus_list_append(Q8tkWidget *widget)
 {
-    if (widget) {
+    if (widget && widget_redrawing == FALSE) {
 	widget_focus_list = q8_list_append(widget_focus_list, widget);
     }
 }
@@ -6429,26 +6463,15 @@ static	Q8tkWidget *widget_focus_list_get_next(Q8tkWidget *widget, int back)
    再帰的に、全ての子ウィジェットも描画する。		*/
 /*------------------------------------------------------*/
 
+static	int	widget_draw_self(Q8tkWidget *widget,
+				 int parent_focus, int parent_sensitive);
+
 static	void	widget_draw(Q8tkWidget *widget,
 			    int parent_focus, int parent_sensitive)
 {
     int		x = widget->x;
     int		y = widget->y;
-    Q8tkWidget	*child = widget->child;
-    int		focus, sensitive;
     int		next_focus;
-    Q8tkWidget	*sense_widget;
-
-    /* 親がフォーカスありか、自身がフォーカスありで、フォーカスあり状態とする*/
-    focus = (parent_focus || (widget == get_focus_widget())) ? TRUE : FALSE;
-
-    /* 親が操作可能で、自身も操作可能なら、操作可能とする */
-    sensitive = (parent_sensitive && widget->sensitive) ? TRUE : FALSE;
-    sense_widget = (sensitive) ? widget : NULL;
-
-    /* 仲間にフォーカスを伝える場合、真。通常は伝えない */
-    next_focus = FALSE;
-
 
 
     widget_scrollin_drawn(widget);
@@ -6487,6 +6510,43 @@ static	void	widget_draw(Q8tkWidget *widget,
 	}
     }
 
+    next_focus = widget_draw_self(widget, parent_focus, parent_sensitive);
+
+
+	/* 自分自身の仲間 (next) が存在すれば、再帰的に処理 */
+  
+    if (widget->next) {
+	widget = widget->next;
+	widget_draw(widget, next_focus, parent_sensitive);
+    }
+}
+
+/* 自分自身 (と子) のみを描画する。仲間にフォーカスを伝えるなら真を返す */
+static	int	widget_draw_self(Q8tkWidget *widget,
+				 int parent_focus, int parent_sensitive)
+{
+    int		x = widget->x;
+    int		y = widget->y;
+    Q8tkWidget	*child = widget->child;
+    int		focus, sensitive;
+    int		next_focus;
+    Q8tkWidget	*sense_widget;
+
+    /* 親がフォーカスありか、自身がフォーカスありで、フォーカスあり状態とする*/
+    focus = (parent_focus || (widget == get_focus_widget())) ? TRUE : FALSE;
+
+    /* 親が操作可能で、自身も操作可能なら、操作可能とする */
+    sensitive = (parent_sensitive && widget->sensitive) ? TRUE : FALSE;
+    sense_widget = (sensitive) ? widget : NULL;
+
+    /* 仲間にフォーカスを伝える場合、真。通常は伝えない */
+    next_focus = FALSE;
+
+    /* 部分描画 (widget_redraw) のために、描画時の状態を覚えておく */
+    widget->draw_serial    = widget_construct_serial;
+    widget->draw_focus     = parent_focus;
+    widget->draw_sensitive = parent_sensitive;
+
 
 		/* 自分自身の typeをもとに枠などを書く。*/
 		/* 子がいれば、x,y を求る。		*/
@@ -6832,13 +6892,122 @@ static	void	widget_draw(Q8tkWidget *widget,
 	}
     }
 
+    return next_focus;
+}
 
-	/* 自分自身の仲間 (next) が存在すれば、再帰的に処理 */
-  
-    if (widget->next) {
-	widget = widget->next;
-	widget_draw(widget, next_focus, parent_sensitive);
+
+
+/*------------------------------------------------------*/
+/* ウィジットの状態 (ボタンの凹凸、フォーカス、カーソル
+   など) だけが変わった場合は、画面構築はせずに、その
+   ウィジットのみを、前回描画した位置に描画しなおす。
+   大きさや配置、フォーカスリストが変わる可能性のある
+   ものは、従来どおり画面構築する。			*/
+/*------------------------------------------------------*/
+
+/* 設定：状態が変わったウィジットを登録する */
+static	void	widget_damage(Q8tkWidget *widget)
+{
+    int i;
+
+    if (get_construct_flag()) return;	/* どうせ全て描画する */
+
+    if (widget == NULL) {
+	set_construct_flag(TRUE);
+	return;
+    }
+
+    switch (widget->type) {		/* 描画しても、大きさや配置が   */
+    case Q8TK_TYPE_BUTTON:		/* 変わらないものに限る		*/
+    case Q8TK_TYPE_TOGGLE_BUTTON:
+    case Q8TK_TYPE_CHECK_BUTTON:
+    case Q8TK_TYPE_RADIO_BUTTON:
+    case Q8TK_TYPE_LABEL:
+    case Q8TK_TYPE_ENTRY:
+    case Q8TK_TYPE_COMBO:
+	break;
+    default:
+	set_construct_flag(TRUE);
+	return;
+    }
+
+    for (i=0; i<widget_damage_nr; i++) {
+	if (widget_damage_list[i] == widget) return;
     }
+    if (widget_damage_nr < MAX_WIDGET_DAMAGE) {
+	widget_damage_list[ widget_damage_nr++ ] = widget;
+    } else {
+	set_construct_flag(TRUE);
+    }
+}
+/* 解除：ウィジット消去時に呼び出す */
+static	void	widget_damage_cancel(Q8tkWidget *widget)
+{
+    int i;
+    for (i=0; i<widget_damage_nr; i++) {
+	if (widget_damage_list[i] == widget) {
+	    widget_damage_list[i] = widget_damage_list[ --widget_damage_nr ];
+	    return;
+	}
+    }
+}
+/* 描画：1つ描画しなおす。描画できない場合は、偽を返す */
+static	int	widget_redraw_one(Q8tkWidget *widget)
+{
+    Q8tkWidget *w, *scrolled = NULL;
+    int sx, sy;
+
+    /* 直前の画面構築で描画されていなければ、不可 (非表示など) */
+    if (widget->draw_serial != widget_construct_serial) return FALSE;
+
+    /* 最前面のウインドウに属していなければ、不可 (上に重なる) */
+    /* スクロールドウインドウの中なら、その表示範囲でマスクする */
+    for (w = widget; w->parent; w = w->parent) {
+	if ((w->parent)->type == Q8TK_TYPE_SCROLLED_WINDOW) {
+	    if (scrolled) return FALSE;
+	    scrolled = w->parent;
+	}
+    }
+    if (window_layer_level < 0 ||
+	w != window_layer[ window_layer_level ]) return FALSE;
+
+    if (scrolled) {
+	sx = scrolled->sx;
+	sy = scrolled->sy;
+	if (scrolled->stat.scrolled.vscrollbar) { sx --; }
+	if (scrolled->stat.scrolled.hscrollbar) { sy --; }
+	q8gr_set_screen_mask(scrolled->x+1, scrolled->y+1, sx-2, sy-2);
+    }
+
+    widget_redrawing = TRUE;
+    widget_draw_self(widget, widget->draw_focus, widget->draw_sensitive);
+    widget_redrawing = FALSE;
+
+    q8gr_reset_screen_mask();
+    return TRUE;
+}
+/* 描画：登録されたウィジットを全て描画しなおす */
+static	void	widget_redraw(void)
+{
+    int i;
+
+    if (widget_damage_nr == 0 && widget_damage_mouse == FALSE) return;
+
+    for (i=0; i<widget_damage_nr; i++) {
+	if (widget_redraw_one(widget_damage_list[i]) == FALSE) {
+	    set_construct_flag(TRUE);
+	    break;
+	}
+    }
+    widget_damage_nr = 0;
+
+    if (get_construct_flag() == FALSE) {
+	if (widget_damage_mouse && disp_cursor) {
+	    q8gr_draw_mouse(mouse.x/8, mouse.y/16);
+	}
+	screen_set_dirty_flag(0);
+    }
+    widget_damage_mouse = FALSE;
 }
 
 
@@ -6868,6 +7037,10 @@ static	void	widget_construct(void)
     int		i, j, tmp;
     Q8tkWidget	*widget;
 
+    widget_construct_serial ++;
+    widget_damage_nr    = 0;	/* 全て描画するので、部分描画は不要 */
+    widget_damage_mouse = FALSE;
+
     q8gr_clear_screen();
 
     for (i=0; i<MAX_WINDOW_LAYER; i++) {
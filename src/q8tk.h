@@ -191,6 +191,10 @@ struct	_Q8tkWidget {
     int		with_label;	/* XXX_new_with_label()	ˤ		*/
 				/* ٥ư硢		*/
 
+    int		draw_serial;	/* Ǹ褵줿ֹ̹̤ۤ	*/
+    char	draw_focus;	/* λΡƤΥե̵ͭ		*/
+    char	draw_sensitive;	/* λΡƤ		*/
+
 
     union {			/* ḁ̊			*/
 
@@ -24,6 +24,11 @@
 #include <string.h>
 #include <ctype.h>
 
+#if	defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#define	HAVE_STARTUP_CLOCK
+#include <sys/time.h>		/* gettimeofday */
+#endif
+
 #include "quasi88.h"
 #include "initval.h"
 
@@ -49,6 +54,13 @@
 #include "pause.h"
 #include "z80.h"
 #include "intr.h"
+#include "simd.h"
+#include "z80-prof.h"
+#include "stats.h"
+#include "remote.h"
+#include "bootcache.h"
+#include "basic.h"
+#include "diskcat.h"
 
 
 int	verbose_level	= DEFAULT_VERBOSE;	/* 冗長レベル		*/
@@ -79,9 +91,58 @@ void	quasi88(void)
 
 /* =========================== メイン処理の初期化 ========================== */
 
-#define	SET_PROC(n)	proc = n; if (verbose_proc) printf("\n"); fflush(NULL);
+#define	SET_PROC(n)	proc = n; if (verbose_proc) startup_lap(n); fflush(NULL);
 static	int	proc = 0;
 
+/*
+ * 起動時間の計測
+ *	-verbose 指定時は、初期化の各段階 (SET_PROC の区切り) に要した時間と、
+ *	起動開始からの経過時間を表示する。
+ *	実時間を ms 単位で得る手段がないシステムでは、表示しない。
+ */
+#ifdef	HAVE_STARTUP_CLOCK
+static	struct timeval	startup_base;		/* 起動開始時刻		*/
+
+static	long	startup_clock(void)		/* 起動開始からの時間 [ms] */
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (long) (tv.tv_sec  - startup_base.tv_sec)  * 1000 +
+	   (long) (tv.tv_usec - startup_base.tv_usec) / 1000;
+}
+
+static	long	startup_t1;			/* 前回の区切りの時刻	*/
+#endif
+
+static	void	startup_lap(int n)
+{
+#ifdef	HAVE_STARTUP_CLOCK
+    static const char *label[] = {
+	"",			/* 0:                          */
+	"",			/* 1: 起動開始                 */
+	"memory",		/* 2: メモリ確保・ROMロード    */
+	"memory/stateload",	/* 3: 〃 (＋ステートロード)    */
+	"screen",		/* 4: グラフィックシステム     */
+	"event/sound",		/* 5: イベント・サウンド       */
+	"timer",		/* 6: タイマー                 */
+	"image/emu",		/* 7: イメージオープン・ワーク */
+    };
+    long t;
+
+    if (n <= 1) {
+	gettimeofday(&startup_base, 0);
+    }
+    t = startup_clock();
+
+    if (n > 1 && n < COUNTOF(label)) {
+	printf("[ %-16s %5ld ms  (total %5ld ms) ]",
+	       label[n], t - startup_t1, t);
+    }
+    startup_t1 = t;
+#endif
+    printf("\n");
+}
+
 void	quasi88_start(void)
 {
     stateload_init();			/* ステートロード関連初期化	*/
@@ -90,17 +151,28 @@ void	quasi88_start(void)
 
     SET_PROC(1);
 
+    simd_init();			/* 命令セットに応じた関数の選択	*/
+
 					/* エミュレート用メモリの確保	*/
     if (memory_allocate() == FALSE) { quasi88_exit(-1); }
 
+#ifdef	USE_MONITOR
+    if (file_basconv) {			/* BASIC 一括変換なら、ここで終了 */
+	quasi88_exit(basic_convert_batch(file_basconv) ? 1 : 0);
+    }
+#endif
+
     if (resume_flag) {			/* ステートロード		*/
-	SET_PROC(2);
+	SET_PROC(2);			/* (この区切りは、メモリ確保分)	*/
 	if (stateload() == FALSE) {
 	    fprintf(stderr, "stateload: Failed ! (filename = %s)\n",
 		    filename_get_state());
 	    quasi88_exit(-1);
 	}
 	if (verbose_proc) printf("Stateload...OK\n"); fflush(NULL);
+
+    } else if (bootcache_load()) {	/* ブートキャッシュがあればロード	*/
+	resume_flag = TRUE;		/* 以降はステートロード時と同じ扱い	*/
     }
     SET_PROC(3);
 
@@ -122,6 +194,7 @@ void	quasi88_start(void)
 
     set_signal();			/* INTシグナルの処理を設定	*/
 
+    diskcat_init();			/* ディスクカタログを読み込む	*/
     imagefile_all_open(resume_flag);	/* イメージファイルを全て開く	*/
 
     					/* エミュ用ワークを順次初期化	*/
@@ -135,10 +208,13 @@ void	quasi88_start(void)
 
     debuglog_init();
     profiler_init();
+    z80prof_init();
 
     emu_breakpoint_init();
 
-    if (verbose_proc) printf("Running QUASI88...\n");
+    remote_init();
+
+    if (verbose_proc) { startup_lap(7); printf("Running QUASI88...\n"); }
 }
 
 /* ======================== メイン処理のメインループ ======================= */
@@ -178,12 +254,15 @@ void	quasi88_stop(int normal_exit)
     switch (proc) {
     case 6:			/* 初期化 正常に終わっている */
 	profiler_exit();
+	z80prof_exit();
+	remote_exit();
 	debuglog_exit();
 	screen_snapshot_exit();
 	key_record_playback_exit();
 	pc88main_term();
 	pc88sub_term();
 	imagefile_all_close();
+	diskcat_exit();
 	wait_vsync_exit();
 	/* FALLTHROUGH */
 
@@ -265,6 +344,41 @@ void	quasi88_exit(int status)
 
 
 
+/***********************************************************************
+ * サウンド出力によるウェイト調整 (-audiosync 指定時)
+ *	サウンドデバイスの出力待ちが audio_sync_frames フレーム分になるよう、
+ *	多ければ減るまで待ち、少なければ待たずに次のフレームを処理する。
+ *	出力待ちの量が分からない場合や、デバイスのバッファが小さく出力待ちが
+ *	目標に届かない場合は、タイマーによるウェイト調整を行う。
+ ************************************************************************/
+static	int	audio_sync_update(void)
+{
+    int per_frame, target, queued;
+
+    per_frame = (int) (xmame_cfg_get_sample_freq() / vsync_freq_hz);
+    target    = per_frame * audio_sync_frames;
+
+    queued = xmame_audio_sync(target, per_frame);
+    if (queued < 0) {
+	return wait_vsync_update();
+    }
+
+    if (queued > target) {			/* 進みすぎていたので、待った */
+	STATS_INC(STATS_AUDIO_SYNC_WAIT);
+	STATS_ADD(STATS_AUDIO_DRIFT_OVER, queued - target);
+	return WAIT_JUST;
+    }
+
+    STATS_ADD(STATS_AUDIO_DRIFT_UNDER, target - queued);
+    if (queued < target - per_frame) {		/* 1フレーム以上遅れている */
+	STATS_INC(STATS_AUDIO_SYNC_RUSH);
+	return WAIT_OVER;
+    }
+    return WAIT_JUST;
+}
+
+
+
 
 
 /***********************************************************************
@@ -388,7 +502,13 @@ int	quasi88_loop(void)
 	switch (mode) {
 	case EXEC:
 	    profiler_lapse( PROF_LAPSE_IDLE );
-	    if (! no_wait) { stat = wait_vsync_update(); }
+	    if (! no_wait) {
+		if (audio_sync && wait_rate == 100) {
+		    stat = audio_sync_update();
+		} else {
+		    stat = wait_vsync_update();
+		}
+	    }
 	    break;
 
 	case MENU:
@@ -409,8 +529,14 @@ int	quasi88_loop(void)
 	/* ウェイト時間を元に、フレームスキップの有無を決定 */
 	if (mode == EXEC) {
 	    frameskip_check((stat == WAIT_JUST) ? TRUE : FALSE);
+
+	    if (stat == WAIT_OVER) { STATS_INC(STATS_WAIT_LATE); }
+	    stats_update();
+	    bootcache_update();
 	}
 
+	remote_update();		/* リモート操作のコマンド処理 */
+
 	/* ウェイト処理が完了したら、次 (INIT か MAIN) に遷移 */
 	step = step_after_wait;
 	return QUASI88_LOOP_ONE;
@@ -435,6 +561,9 @@ static	void	set_mode(int newmode)
 	if (mode == MENU) {		/* メニューから他モードの切替は */
 	    q8tk_event_quit();		/* Q8TK の終了が必須            */
 	}
+	if (newmode == MENU || newmode == MONITOR) {
+	    bootcache_cancel();		/* 設定変更の可能性があるので中止 */
+	}
 
 	next_mode = newmode;
 	quasi88_event_flags |= EVENT_MODE_CHANGED;
@@ -627,6 +756,8 @@ void	quasi88_reset(const T_RESET_CFG *cfg)
 
     if (verbose_proc) printf("Reset QUASI88...start\n");
 
+    bootcache_cancel();
+
     pc88main_term();
     pc88sub_term();
 
@@ -692,6 +823,8 @@ int	quasi88_stateload(int serial)
 
     if (verbose_proc) printf("Stateload...start (%s)\n",filename_get_state());
 
+    bootcache_cancel();
+
     if (stateload_check_file_exist() == FALSE) {	/* ファイルなし */
 	if (quasi88_is_exec()) {
 	    status_message(1, STATUS_INFO_TIME, "State-Load file not found !");
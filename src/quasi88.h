@@ -111,7 +111,8 @@ enum {
     EVENT_AUDIO_UPDATE	= 0x0002,
     EVENT_MODE_CHANGED	= 0x0004,
     EVENT_DEBUG		= 0x0008,
-    EVENT_QUIT		= 0x0010
+    EVENT_QUIT		= 0x0010,
+    EVENT_AUDIO_PART	= 0x0020
 };
 extern	int	quasi88_event_flags;
 extern	int	quasi88_debug_pause;	/* 1ʤpause, 0ʤmonitor */
@@ -0,0 +1,406 @@
+/************************************************************************/
+/*									*/
+/* リモート操作 (UNIXドメインソケット)					*/
+/*									*/
+/************************************************************************/
+
+/*
+  -remote <path> で指定したパスに UNIXドメインソケットを作成し、接続して
+  きたクライアントからのコマンドを処理する。ソケットはノンブロッキングで、
+  quasi88_loop() から 1フレーム毎に remote_update() でポーリングする。
+
+  コマンドは 1行に 1つ。まとめて送ってもよい (バッチ)。各コマンドに対して
+  "ok ..." か "err ..." の 1行を返す。
+
+	reset			リセット
+	disk <drv> <file> [img]	ドライブ <drv> (1/2) にディスクを挿入
+	eject <drv>		ドライブ <drv> (1/2) のディスクを取り出す
+	stateload [n]		ステートロード (n は連番)
+	statesave [n]		ステートセーブ (n は連番)
+	snapshot		画面スナップショットを保存
+	wait <rate>		ウェイトの比率 [%] を設定
+	nowait <0|1>		ウェイトなしの設定
+	key <code> <0|1>	キーを押す/離す (code は KEY88_XXX の値)
+	exec / pause		実行 / 一時停止
+	run <frames>		指定フレーム数 (実行中のみ数える) 経過後に
+				"ok" を返す。それまで後続のコマンドは保留
+	hash			画面と出力音のハッシュ値を返す。
+				  "ok frame=XXXXXXXX audio=XXXXXXXX"
+				音は、前回の hash 以降に出力した分
+	frame			画面イメージを返す。
+				  "ok frame <w> <h> <bpp>" の行に続けて
+				  w * h * bpp/8 バイトの生データ
+	stats			動作状況カウンタを JSON で返す
+	quit			終了
+
+  応答を読まずにコマンドを送り続けるクライアントで送信待ちが溜まり続けない
+  よう、送信待ちが画面イメージ REMOTE_BACKLOG 個分を超えたら切断する。
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "quasi88.h"
+#include "initval.h"
+#include "remote.h"
+
+#ifdef	USE_REMOTE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "event.h"
+#include "keyboard.h"
+#include "screen.h"
+#include "snddrv.h"
+#include "stats.h"
+
+#ifndef	MSG_NOSIGNAL			/* 切断時に SIGPIPE を発生させない */
+#define	MSG_NOSIGNAL	(0)
+#endif
+
+
+char	*file_remote = NULL;		/* ソケットのパス名		*/
+
+
+#define	REMOTE_CLIENTS	(4)		/* 同時に接続できる数		*/
+#define	REMOTE_LINE	(1024)		/* コマンド 1行の最大長		*/
+#define	REMOTE_BACKLOG	(4)		/* 送信待ちの上限 (画面イメージ数)*/
+
+typedef	struct {
+    int		fd;			/* -1 なら未使用		*/
+    char	in[ REMOTE_LINE ];	/* 受信したコマンド (行未満)	*/
+    int		in_len;
+    char	*out;			/* 送信待ちのデータ		*/
+    int		out_len;
+    int		out_size;
+    int		overflow;		/* 真なら、送信待ちが上限を超えた*/
+    int		run;			/* run コマンドの残りフレーム数	*/
+} T_REMOTE_CLIENT;
+
+static	int		listen_fd = -1;
+static	T_REMOTE_CLIENT	client[ REMOTE_CLIENTS ];
+
+
+
+/*----------------------------------------------------------------------
+ * 送信データを溜める (実際の送信は、remote_flush で)
+ *----------------------------------------------------------------------*/
+static	int	remote_put(T_REMOTE_CLIENT *c, const void *data, int size)
+{
+    int limit = REMOTE_BACKLOG * (SCREEN_W * SCREEN_H * DEPTH / 8) + REMOTE_LINE;
+
+    if (c->overflow) return FALSE;
+    if (c->out_len + size > limit) {	/* 溜まりすぎ。切断させる */
+	c->overflow = TRUE;
+	return FALSE;
+    }
+
+    if (c->out_len + size > c->out_size) {
+	int   new_size = (c->out_len + size) * 2;
+	char *p = (char *)realloc(c->out, new_size);
+	if (p == NULL) return FALSE;
+	c->out      = p;
+	c->out_size = new_size;
+    }
+    memcpy(c->out + c->out_len, data, size);
+    c->out_len += size;
+    return TRUE;
+}
+
+static	void	remote_reply(T_REMOTE_CLIENT *c, const char *msg)
+{
+    remote_put(c, msg, strlen(msg));
+    remote_put(c, "\n", 1);
+}
+
+static	int	remote_flush(T_REMOTE_CLIENT *c)
+{
+    int n;
+
+    while (c->out_len > 0) {
+	n = send(c->fd, c->out, c->out_len, MSG_NOSIGNAL);
+	if (n < 0) {
+	    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+	    if (errno == EINTR) continue;
+	    return FALSE;
+	}
+	memmove(c->out, c->out + n, c->out_len - n);
+	c->out_len -= n;
+    }
+    return TRUE;
+}
+
+static	void	remote_close(T_REMOTE_CLIENT *c)
+{
+    close(c->fd);
+    free(c->out);
+    memset(c, 0, sizeof(*c));
+    c->fd = -1;
+}
+
+
+
+/*----------------------------------------------------------------------
+ * 画面イメージ
+ *----------------------------------------------------------------------*/
+static	bit32	remote_frame_hash(void)
+{
+    bit32 h = 2166136261u;
+    int   x, y;
+    int   line = SCREEN_W * DEPTH / 8;
+    const byte *p;
+
+    for (y = 0; y < SCREEN_H; y++) {
+	p = (const byte *)screen_start + y * (WIDTH * DEPTH / 8);
+	for (x = 0; x < line; x++) {
+	    h = (h ^ p[x]) * 16777619u;
+	}
+    }
+    return h;
+}
+
+static	void	remote_frame(T_REMOTE_CLIENT *c)
+{
+    char buf[64];
+    int  y;
+    int  line = SCREEN_W * DEPTH / 8;
+
+    sprintf(buf, "ok frame %d %d %d", SCREEN_W, SCREEN_H, DEPTH);
+    remote_reply(c, buf);
+
+    for (y = 0; y < SCREEN_H; y++) {
+	remote_put(c, screen_start + y * (WIDTH * DEPTH / 8), line);
+    }
+}
+
+
+
+/*----------------------------------------------------------------------
+ * コマンド 1行を処理する
+ *----------------------------------------------------------------------*/
+static	void	remote_command(T_REMOTE_CLIENT *c, char *line)
+{
+    char buf[ STATS_JSON_SIZE + 8 ];
+    char *cmd, *arg1, *arg2, *arg3;
+    int  ok = TRUE;
+
+    cmd  = strtok(line, " \t\r");
+    arg1 = strtok(NULL, " \t\r");
+    arg2 = strtok(NULL, " \t\r");
+    arg3 = strtok(NULL, " \t\r");
+
+    if (cmd == NULL) return;			/* 空行は無視 */
+
+    if        (strcmp(cmd, "reset") == 0) {
+	quasi88_reset(NULL);
+
+    } else if (strcmp(cmd, "disk") == 0 && arg1 && arg2) {
+	int drv = atoi(arg1) - 1;
+	if (drv != DRIVE_1 && drv != DRIVE_2) ok = FALSE;
+	else ok = quasi88_disk_insert(drv, arg2, (arg3) ? atoi(arg3) : 0, FALSE);
+
+    } else if (strcmp(cmd, "eject") == 0 && arg1) {
+	int drv = atoi(arg1) - 1;
+	if (drv != DRIVE_1 && drv != DRIVE_2) ok = FALSE;
+	else quasi88_disk_eject(drv);
+
+    } else if (strcmp(cmd, "stateload") == 0) {
+	ok = quasi88_stateload((arg1) ? atoi(arg1) : -1);
+
+    } else if (strcmp(cmd, "statesave") == 0) {
+	ok = quasi88_statesave((arg1) ? atoi(arg1) : -1);
+
+    } else if (strcmp(cmd, "snapshot") == 0) {
+	ok = quasi88_screen_snapshot();
+
+    } else if (strcmp(cmd, "wait") == 0 && arg1) {
+	quasi88_cfg_set_wait_rate(atoi(arg1));
+
+    } else if (strcmp(cmd, "nowait") == 0 && arg1) {
+	quasi88_cfg_set_no_wait(atoi(arg1));
+
+    } else if (strcmp(cmd, "key") == 0 && arg1 && arg2) {
+	int code = strtol(arg1, NULL, 0);
+	if (code <= 0 || code >= KEY88_END) ok = FALSE;
+	else quasi88_key(code, atoi(arg2));
+
+    } else if (strcmp(cmd, "exec") == 0) {
+	quasi88_exec();
+
+    } else if (strcmp(cmd, "pause") == 0) {
+	quasi88_pause();
+
+    } else if (strcmp(cmd, "run") == 0 && arg1) {
+	c->run = atoi(arg1);
+	if (c->run > 0) return;			/* 応答は、終了時に */
+
+    } else if (strcmp(cmd, "hash") == 0) {
+	sprintf(buf, "ok frame=%08X audio=%08X",
+		remote_frame_hash(), xmame_audio_hash());
+	remote_reply(c, buf);
+	return;
+
+    } else if (strcmp(cmd, "frame") == 0) {
+	remote_frame(c);
+	return;
+
+    } else if (strcmp(cmd, "stats") == 0) {
+	strcpy(buf, "ok ");
+	stats_json(buf + 3);
+	buf[ strlen(buf) - 1 ] = '\0';		/* 末尾の改行を削る */
+	remote_reply(c, buf);
+	return;
+
+    } else if (strcmp(cmd, "quit") == 0) {
+	quasi88_quit();
+
+    } else {
+	remote_reply(c, "err unknown command");
+	return;
+    }
+
+    remote_reply(c, (ok) ? "ok" : "err failed");
+}
+
+
+
+/*----------------------------------------------------------------------
+ * 受信したデータから、行単位でコマンドを取り出して処理する
+ *	run の実行中は、そこで処理を止める
+ *----------------------------------------------------------------------*/
+static	int	remote_receive(T_REMOTE_CLIENT *c)
+{
+    int  n, i;
+    char *eol;
+
+    for (;;) {
+					/* 溜まっている行を処理 */
+	while (c->run == 0 && c->overflow == FALSE &&
+	       (eol = memchr(c->in, '\n', c->in_len)) != NULL) {
+	    *eol = '\0';
+	    i = eol - c->in + 1;
+	    remote_command(c, c->in);
+	    memmove(c->in, c->in + i, c->in_len - i);
+	    c->in_len -= i;
+	}
+	if (c->overflow) {
+	    if (verbose_proc) printf("remote: client not reading, closed\n");
+	    return FALSE;
+	}
+	if (c->run) return TRUE;
+
+	if (c->in_len >= REMOTE_LINE - 1) {	/* 長すぎる行は捨てる */
+	    c->in_len = 0;
+	    remote_reply(c, "err line too long");
+	}
+					/* 新たに受信 */
+	n = read(c->fd, c->in + c->in_len, REMOTE_LINE - 1 - c->in_len);
+	if (n == 0) return FALSE;		/* 切断された */
+	if (n < 0) {
+	    if (errno == EAGAIN || errno == EWOULDBLOCK) return TRUE;
+	    if (errno == EINTR) continue;
+	    return FALSE;
+	}
+	c->in_len += n;
+    }
+}
+
+
+
+/*----------------------------------------------------------------------
+ * 初期化・終了・ポーリング
+ *----------------------------------------------------------------------*/
+void	remote_init(void)
+{
+    struct sockaddr_un addr;
+    int i;
+
+    for (i = 0; i < REMOTE_CLIENTS; i++) {
+	client[i].fd = -1;
+    }
+
+    if (file_remote == NULL) return;
+
+    if (strlen(file_remote) >= sizeof(addr.sun_path)) {
+	printf("remote: path too long (%s)\n", file_remote);
+	return;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, file_remote);
+
+    unlink(file_remote);			/* 前回の残骸を削除 */
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 ||
+	bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	listen(listen_fd, REMOTE_CLIENTS) < 0) {
+
+	printf("remote: can't open socket (%s)\n", file_remote);
+	if (listen_fd >= 0) close(listen_fd);
+	listen_fd = -1;
+	return;
+    }
+    fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK);
+
+    if (verbose_proc) printf("+ Remote control socket (%s)\n", file_remote);
+}
+
+void	remote_exit(void)
+{
+    int i;
+
+    for (i = 0; i < REMOTE_CLIENTS; i++) {
+	if (client[i].fd >= 0) remote_close(&client[i]);
+    }
+    if (listen_fd >= 0) {
+	close(listen_fd);
+	listen_fd = -1;
+	unlink(file_remote);
+    }
+}
+
+void	remote_update(void)
+{
+    int i, fd;
+    T_REMOTE_CLIENT *c;
+
+    if (listen_fd < 0) return;
+
+					/* 新たな接続 */
+    while ((fd = accept(listen_fd, NULL, NULL)) >= 0) {
+	for (i = 0; i < REMOTE_CLIENTS; i++) {
+	    if (client[i].fd < 0) break;
+	}
+	if (i == REMOTE_CLIENTS) {		/* 空きなし */
+	    close(fd);
+	    continue;
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	memset(&client[i], 0, sizeof(client[i]));
+	client[i].fd = fd;
+    }
+
+					/* 各接続のコマンド処理 */
+    for (i = 0; i < REMOTE_CLIENTS; i++) {
+	c = &client[i];
+	if (c->fd < 0) continue;
+
+	if (c->run && quasi88_is_exec()) {
+	    if (-- c->run == 0) remote_reply(c, "ok");
+	}
+
+	if (remote_receive(c) == FALSE || remote_flush(c) == FALSE) {
+	    remote_close(c);
+	}
+    }
+}
+
+#endif	/* USE_REMOTE */
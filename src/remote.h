@@ -0,0 +1,28 @@
+#ifndef REMOTE_H_INCLUDED
+#define REMOTE_H_INCLUDED
+
+
+/*----------------------------------------------------------------------
+ * ⡼ (UNIXɥᥤ󥽥å)
+ *	-remote <path> ǻꤷåȤˡ11ޥɤΥƥȤ
+ *	quasi88_reset() ʤɤԤܺ٤ remote.c 򻲾ȡ
+ *----------------------------------------------------------------------*/
+
+#ifdef	USE_REMOTE
+
+extern	char	*file_remote;		/* åȤΥѥ̾		*/
+
+void	remote_init(void);
+void	remote_exit(void);
+void	remote_update(void);
+
+#else
+
+#define	remote_init()
+#define	remote_exit()
+#define	remote_update()
+
+#endif
+
+
+#endif	/* REMOTE_H_INCLUDED */
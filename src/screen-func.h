@@ -8,6 +8,12 @@ enum {	V_DIF,	  V_ALL,			  V_METHOD    };
 
 /* void (*ؿꥹ[ V_VRAM_MODE ][ V_TEXT_MODE ][ V_METHOD ])(void); */
 
+/* V_DIF δؿžΰΰʸԤϢ³ϰϤȤˡ
+   ؿͤƱ (x0, y0, x1, y1  8ӥåȤ) ǥåȤ */
+#define	V_DIF_RECT_MAX	(13)
+extern	int	vram2screen_rect[ V_DIF_RECT_MAX ];
+extern	int	vram2screen_nr_rect;
+
 /* ------------------------------------------------------------------------- */
 #ifdef	SUPPORT_8BPP
 extern	int  (*vram2screen_list_F_N__8[4][4][2])(void);
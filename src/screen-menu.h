@@ -7,9 +7,16 @@ extern	int	menu_cursor_y;
  *	˥塼⡼ɤβ
  *****************************************************************************/
 #ifdef		MENU2SCREEN
+
+/* ꥢ (ʸñ̡x1,y1 ޤ) žΰη˥ѥå */
+#define	MENU_RECT(x0, y0, x1, y1)			\
+	(((x0) << 24) | (((y0) * 8) << 16) | (((x1) + 1) << 8) | (((y1) + 1) * 8))
+
 int		MENU2SCREEN(void)
 {
     int x, y;
+    int rx0 = Q8GR_SCREEN_X-1, rx1 = 0, ry0 = -1;	/* Ϣ³ԤΥꥢ */
+    int row_changed;
     T_Q8GR_SCREEN *old = &menu_screen[menu_screen_current ^ 1][0][0];
     T_Q8GR_SCREEN *src = &menu_screen[menu_screen_current    ][0][0];
     TYPE		*dst = (TYPE *) SCREEN_START;
@@ -17,7 +24,10 @@ int		MENU2SCREEN(void)
 
     /*menu_cursor_x = menu_cursor_y = -1;*/
 
+    vram2screen_nr_rect = 0;
+
     for (y = 0; y < Q8GR_SCREEN_Y; y++) {
+	row_changed = FALSE;
 	for (x = 0; x < Q8GR_SCREEN_X; x++) {
 
 	    if (*((Uint *) src) != *((Uint *) old)) {
@@ -34,6 +44,7 @@ int		MENU2SCREEN(void)
 		if (src->mouse) { menu_cursor_x = x; menu_cursor_y = y; }
 
 		if(y<y0) y0=y;	if(y>y1) y1=y;	if(x<x0) x0=x;	if(x>x1) x1=x;
+		if(x<rx0) rx0=x;  if(x>rx1) rx1=x;  row_changed = TRUE;
 
 		switch (src->font_type) {
 		case FONT_ANK:
@@ -103,14 +114,28 @@ int		MENU2SCREEN(void)
 	    dst += FONT_W;
 	}
 	dst += FONT_H * SCREEN_WIDTH - SCREEN_SX;
+
+	if (row_changed) {		/* Ԥ³֤ϡꥢ򹭤 */
+	    if (ry0 < 0) ry0 = y;
+	} else if (ry0 >= 0) {		/* ڤ줿顢žΰ1ĳ */
+	    vram2screen_rect[ vram2screen_nr_rect++ ]
+					= MENU_RECT(rx0, ry0, rx1, y - 1);
+	    rx0 = Q8GR_SCREEN_X-1;  rx1 = 0;  ry0 = -1;
+	}
+    }
+
+    if (ry0 >= 0) {
+	vram2screen_rect[ vram2screen_nr_rect++ ]
+				= MENU_RECT(rx0, ry0, rx1, Q8GR_SCREEN_Y - 1);
     }
 
     if (x0 <= x1) {
-	return ((x0 << 24) | ((y0 << 16) * 8) | ((x1+1) << 8) | ((y1+1) * 8));
+	return MENU_RECT(x0, y0, x1, y1);
     } else {
 	return -1;
     }
 }
+#undef	MENU_RECT
 #endif		/* MENU2SCREEN */
 
 /******************************************************************************
@@ -17,13 +17,13 @@
 
 #define		COLUMNS		(80)
 #define		COLUMN_SKIP	(1)
-#define		DIRTY_TYPE	unsigned char
+#define		DIRTY_MASK	(0x1)
 
 #elif	(TEXT_WIDTH == 40)
 
 #define		COLUMNS		(40)
 #define		COLUMN_SKIP	(2)
-#define		DIRTY_TYPE	unsigned short
+#define		DIRTY_MASK	(0x3)
 
 #else
 #error
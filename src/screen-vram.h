@@ -18,11 +18,24 @@
  *	VRAM / TEXT Ρ褫鹹줿ʬ
  *****************************************************************************/
 #ifdef		VRAM2SCREEN_DIFF
+
+/* ꥢ (ʸñ̡x1,y1 ޤ) žΰη˥ѥå */
+#define	DIF_RECT(x0, y0, x1, y1)			\
+	((( (x0)      * COLUMN_SKIP ) << 24) |		\
+	 ((( y0)      * (200 / ROWS)) << 16) |		\
+	 ((((x1) + 1) * COLUMN_SKIP ) <<  8) |		\
+	 ((((y1) + 1) * (200 / ROWS))	   ))
+
 static	int	VRAM2SCREEN_DIFF(void)
 {
     int x0 = COLUMNS-1, x1 = 0, y0 = ROWS-1, y1 = 0;	/* ꥢ */
+    int rx0 = COLUMNS-1, rx1 = 0, ry0 = -1;	/* Ϣ³ԤΥꥢ */
+    int row_changed;
     int i, j, k;
     int changed_line;	/* 饤ӥå(0CHARA_LINES-1)ɽ */
+    bit32 row_lines;	/*  VRAM 줿饤Υӥå	  */
+    bit32 lines;
+    int   pos;		/* ʬե饰ΥӥåȰ			  */
 
     unsigned short text, *text_attr= &text_attr_buf[ text_attr_flipflop	  ][0];
     unsigned short old,	 *old_attr = &text_attr_buf[ text_attr_flipflop^1 ][0];
@@ -31,16 +44,20 @@ static	int	VRAM2SCREEN_DIFF(void)
     bit8    style = 0;				/* եȤλ 8ɥåʬ */
     int	    tpal;				/* եȤο	    */
     TYPE    tcol;				/* եȤο		    */
-    DIRTY_TYPE *up =
-	(DIRTY_TYPE *) &screen_dirty_flag[0];	/* VRAMե饰ؤΥݥ*/
     bit32 *src = main_vram4;			/* VRAMؤΥݥ	     */
     DST_DEFINE()				/* 襨ꥢؤΥݥ    */
     WORK_DEFINE()				/* ɬפʥ	     */
 
+    vram2screen_nr_rect = 0;
+
     /* 1ʸñ̤褹롣  ԡ߷ ʬ롼	 (40ʤ2ʸʬƱ˽) */
 
     for (i = 0; i < ROWS; i++) {/*===========================================*/
 
+	/* ιԤ VRAM 饤0 ʤ顢VRAM κʬĴ٤ʤƤ褤 */
+	row_lines = screen_dirty_lines(i * CHARA_LINES, CHARA_LINES);
+	row_changed = FALSE;
+
 	for (j = 0; j < COLUMNS; j++) {/*------------------------------------*/
 
 	    text = *text_attr;	text_attr += COLUMN_SKIP;  /* ƥȥ */
@@ -51,13 +68,19 @@ static	int	VRAM2SCREEN_DIFF(void)
 	    }
 	    else {				/* no 饤õ */
 		changed_line = 0;
-		for (k = 0; k < CHARA_LINES; k++) {
-		    if (up[ k * COLUMNS ]) { changed_line |= (1 << k); }
+		for (lines = row_lines; lines; lines &= lines - 1) {
+		    k = screen_dirty_ctz(lines);
+		    pos = (i * CHARA_LINES + k) * 80 + j * COLUMN_SKIP;
+		    if ((screen_dirty_flag[ pos >> 6 ] >> (pos & 63))
+								& DIRTY_MASK) {
+			changed_line |= (1 << k);
+		    }
 		}
 	    }
 
 	    if (changed_line) {		    /* 줫Υ饤 ? */
 		if (i<y0) y0=i; if (i>y1) y1=i; if (j<x0) x0=j; if (j>x1) x1=j;
+		if (j<rx0) rx0=j; if (j>rx1) rx1=j; row_changed = TRUE;
 
 		get_font_gryph( text, &fnt, &tpal );  /* եȤη */
 		tcol = COLOR_PIXEL( tpal );
@@ -87,25 +110,36 @@ static	int	VRAM2SCREEN_DIFF(void)
 		DST_RESTORE_LINE();		/* 饤Ƭ᤹	     */
 	    }
 
-	    up++;			    /* ʸ֤˿ʤ	     */
+					    /* ʸ֤˿ʤ	     */
 	    src += COLUMN_SKIP;
 	    DST_NEXT_CHARA();
 	}			       /*------------------------------------*/
 
-	up  += (CHARA_LINES - 1) * COLUMNS;	/* ιԤƬʸ֤˿ʤ*/
+	if (row_changed) {		/* Ԥ³֤ϡꥢ򹭤 */
+	    if (ry0 < 0) ry0 = i;
+	} else if (ry0 >= 0) {		/* ڤ줿顢žΰ1ĳ */
+	    vram2screen_rect[ vram2screen_nr_rect++ ]
+					= DIF_RECT(rx0, ry0, rx1, i - 1);
+	    rx0 = COLUMNS-1;  rx1 = 0;  ry0 = -1;
+	}
+
+						/* ιԤƬʸ֤˿ʤ*/
 	src += (CHARA_LINES - 1) * 80;
 	DST_NEXT_TOP_CHARA();
     }				/*===========================================*/
 
+    if (ry0 >= 0) {
+	vram2screen_rect[ vram2screen_nr_rect++ ]
+					= DIF_RECT(rx0, ry0, rx1, ROWS - 1);
+    }
+
     if (x0 <= x1) {
-	return ((( x0	   * COLUMN_SKIP ) << 24) |
-		(((y0	 ) * (200 / ROWS)) << 16) |
-		(((x1 + 1) * COLUMN_SKIP ) <<  8) |
-		(((y1 + 1) * (200 / ROWS))	));
+	return DIF_RECT(x0, y0, x1, y1);
     } else {
 	return -1;
     }
 }
+#undef	DIF_RECT
 #endif		/* VRAM2SCREEN_DIFF */
 
 
@@ -212,7 +246,7 @@ static	int	VRAM2SCREEN_ALL(void)
 #undef	COLUMN_SKIP
 #undef	ROWS
 #undef	CHARA_LINES
-#undef	DIRTY_TYPE
+#undef	DIRTY_MASK
 
 #undef	get_pixel_index73
 #undef	get_pixel_index62
@@ -16,6 +16,7 @@
 #include "pc88main.h"
 
 #include "status.h"
+#include "stats.h"
 #include "suspend.h"
 
 #include "intr.h"
@@ -34,7 +35,8 @@ byte	grph_pile;			/* OUT[53] 重ね合わせ		*/
 
 
 
-char	screen_dirty_flag[ 0x4000*2 ];		/* メイン領域 差分更新	*/
+T_DIRTY_WORD screen_dirty_flag[ SCREEN_DIRTY_WORDS ];	/* メイン領域 差分更新*/
+T_DIRTY_WORD screen_dirty_line[ SCREEN_DIRTY_LINES ];	/* 〃 ライン毎の集計  */
 int	screen_dirty_all = TRUE;		/* メイン領域 全域更新	*/
 int	screen_dirty_palette = TRUE;		/* 色情報 更新		*/
 int	screen_dirty_status = FALSE;		/* ステータス領域 更新	*/
@@ -1246,6 +1248,52 @@ static	void	set_vram2screen_list(void)
 }
 
 
+int	vram2screen_rect[ V_DIF_RECT_MAX ];	/* 差分転送した領域の一覧 */
+int	vram2screen_nr_rect;
+
+
+
+/*----------------------------------------------------------------------
+ * 差分更新フラグ screen_dirty_flag を、ライン単位に集計する
+ *	1ワード (64バイト分) は、最大で 2ライン (80バイト/ライン) にまたがる
+ *----------------------------------------------------------------------*/
+static	void	screen_dirty_summarize(void)
+{
+    int n, pos, l, b;
+    T_DIRTY_WORD w;
+
+    memset(screen_dirty_line, 0, sizeof(screen_dirty_line));
+
+    for (n = 0; n < (80 * 400) / 64; n++) {
+	w = screen_dirty_flag[n];
+	if (w == 0) continue;
+
+	pos = n * 64;
+	l   = pos / 80;
+	b   = (l + 1) * 80 - pos;	/* このワード内の、ライン l のビット数 */
+
+	if (b >= 64 || (w & (((T_DIRTY_WORD) 1 << b) - 1))) {
+	    screen_dirty_line[ l >> 6 ] |= (T_DIRTY_WORD) 1 << (l & 63);
+	}
+	if (b < 64 && (w >> b)) {
+	    l ++;
+	    screen_dirty_line[ l >> 6 ] |= (T_DIRTY_WORD) 1 << (l & 63);
+	}
+    }
+}
+
+#ifndef	__GNUC__
+/* w の最下位の 1 のビット位置 (w は 0 以外のこと) */
+int	screen_dirty_ctz(T_DIRTY_WORD w)
+{
+    int n = 0;
+    while ((w & 1) == 0) { w >>= 1; n++; }
+    return n;
+}
+#endif
+
+
+
 static	void	clear_all_screen(void)
 {
     if (draw_start) { (draw_start)(); }		/* システム依存の描画前処理 */
@@ -1346,15 +1394,22 @@ static	void	put_image_all(void)
 
 
 /*----------------------------------------------------------------------
- * 画面表示	メイン領域の (x0,y0)-(x1,y1) と 指定されたステータス領域を表示
+ * 画面表示	メイン領域の nr_area 個の領域と 指定されたステータス領域を表示
+ *		area[] は、vram2screen() の戻り値と同じ形式
  *----------------------------------------------------------------------*/
-static	void	put_image(int x0, int y0, int x1, int y1,
+static	void	put_image(int nr_area, const int area[],
 			  int st0, int st1, int st2)
 {
-    int n = 0;
-    T_GRAPH_RECT rect[4];
+    int i, n = 0;
+    int x0, y0, x1, y1;
+    T_GRAPH_RECT rect[ V_DIF_RECT_MAX + 3 ];
+
+    for (i = 0; i < nr_area; i++) {
+	x0 = ((area[i] >> 24)       ) * 8;
+	y0 = ((area[i] >> 16) & 0xff) * 2;
+	x1 = ((area[i] >>  8) & 0xff) * 8;
+	y1 = ((area[i]      ) & 0xff) * 2;
 
-    if (x0 >= 0) {
 	if        (now_screen_size == SCREEN_SIZE_FULL) {
 	    ;
 	} else if (now_screen_size == SCREEN_SIZE_HALF) {
@@ -1508,6 +1563,8 @@ void	screen_update(void)
 
     screen_attr_update();	/* マウス自動で隠す…呼び出し場所がいまいち */
 
+    vram2screen_nr_rect = 0;
+
 
     if (is_exec) {
 	profiler_lapse( PROF_LAPSE_BLIT );
@@ -1623,9 +1680,11 @@ void	screen_update(void)
 		    memset(screen_dirty_flag, 0, sizeof(screen_dirty_flag) / 2);
 		}
 		if (! (grph_ctrl & (GRPH_CTRL_COLOR|GRPH_CTRL_200))) {
-		    /* 400ライン */
-		    memcpy(&screen_dirty_flag[80*200], screen_dirty_flag, 80*200);
+		    /* 400ライン (80*200 ビットは、ちょうどワード境界) */
+		    memcpy(&screen_dirty_flag[(80*200) / 64], screen_dirty_flag,
+			   (80*200) / 8);
 		}
+		screen_dirty_summarize();
 	    }
 
 	    crtc_make_text_attr();	/* TVRAM の 属性一覧作成	  */
@@ -1675,6 +1734,10 @@ void	screen_update(void)
     if (is_exec) {
 	profiler_video_output(((frame_counter % frameskip_rate) == 0),
 			      skip, (all_area || rect != -1));
+
+	if ((frame_counter % frameskip_rate) != 0 || skip) {
+	    STATS_INC(STATS_FRAME_SKIP);
+	}
     }
 
 
@@ -1695,13 +1758,17 @@ void	screen_update(void)
 
     } else {
 	if (rect != -1) {
-	    put_image(((rect >> 24)       ) * 8, ((rect >> 16) & 0xff) * 2,
-		      ((rect >>  8) & 0xff) * 8, ((rect      ) & 0xff) * 2,
-		      (flag & 1), (flag & 2), (flag & 4));
+	    if (vram2screen_nr_rect > 0) {	/* 差分転送なら、行範囲毎 */
+		put_image(vram2screen_nr_rect, vram2screen_rect,
+			  (flag & 1), (flag & 2), (flag & 4));
+	    } else {
+		put_image(1, &rect,
+			  (flag & 1), (flag & 2), (flag & 4));
+	    }
 	    drawn_count ++;
 	}
 	else if (flag) {
-	    put_image(-1, -1, -1, -1,
+	    put_image(0, NULL,
 		      (flag & 1), (flag & 2), (flag & 4));
 	}
     }
@@ -45,7 +45,17 @@ extern	byte	grph_pile;			/* OUT[53] 
 
 	/* 躹ʬ */
 
-extern	char	screen_dirty_flag[ 0x4000*2 ];	/* ᥤΰ ʬ	*/
+	/* ᥤΰκʬե饰ϡVRAM 1ХȤˤĤ 1ӥåȡ
+	   ӥåȰ֤ 饤80ܷ (400饤βȾʬ 200饤)
+	   screen_dirty_line ϡľ˥饤ñ̤˽פΡ */
+
+typedef	unsigned long long	T_DIRTY_WORD;
+
+#define	SCREEN_DIRTY_WORDS	((0x4000*2) / 64)
+#define	SCREEN_DIRTY_LINES	(400 / 64 + 1)
+
+extern	T_DIRTY_WORD	screen_dirty_flag[ SCREEN_DIRTY_WORDS ];/* ʬ	*/
+extern	T_DIRTY_WORD	screen_dirty_line[ SCREEN_DIRTY_LINES ];/* 饤	*/
 extern	int	screen_dirty_all;		/* ᥤΰ 蹹	*/
 extern	int	screen_dirty_palette;		/*  		*/
 extern	int	screen_dirty_status;		/* ơΰ 	*/
@@ -53,7 +63,8 @@ extern	int	screen_dirty_status_hide;	/* 
 extern	int	screen_dirty_status_show;	/* ơΰ */
 extern	int	screen_dirty_frame;		/* ΰ 		*/
 
-#define	screen_set_dirty_flag(x)	screen_dirty_flag[x] = 1
+#define	screen_set_dirty_flag(x)	\
+		screen_dirty_flag[(x) >> 6] |= (T_DIRTY_WORD) 1 << ((x) & 63)
 #define	screen_set_dirty_all()		screen_dirty_all = TRUE
 #define	screen_set_dirty_palette()	do {				\
 					  screen_dirty_palette = TRUE;	\
@@ -64,6 +75,20 @@ extern	int	screen_dirty_frame;		/* 
 #define	screen_set_dirty_status_show()	screen_dirty_status_show = TRUE
 #define	screen_set_dirty_frame()	screen_dirty_frame = TRUE;
 
+#ifdef	__GNUC__
+#define	screen_dirty_ctz(w)		__builtin_ctzll(w)
+#else
+int	screen_dirty_ctz(T_DIRTY_WORD w);
+#endif
+
+/* 饤 l0  n 饤ʬ (n <= 32) ι̵ͭ򡢥ӥåȤ֤ */
+#define	screen_dirty_lines(l0, n)					\
+	((bit32) ((screen_dirty_line[(l0) >> 6] >> ((l0) & 63)) |	\
+		  ((((l0) & 63) + (n) > 64)				\
+		   ? screen_dirty_line[((l0) >> 6) + 1] << (64 - ((l0) & 63)) \
+		   : 0))						\
+	 & (bit32) (((T_DIRTY_WORD) 1 << (n)) - 1))
+
 
 	/* ¾ */
 
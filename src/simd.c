@@ -0,0 +1,109 @@
+/************************************************************************/
+/*									*/
+/* 命令セット (SSE2/SSSE3/AVX2/NEON) に応じたカーネルの選択		*/
+/*									*/
+/************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "quasi88.h"
+#include "simd.h"
+
+
+int	simd_level       = SIMD_C;	/* 選択された命令セット		*/
+int	simd_level_force = -1;		/* -kernels での指定 (-1 で自動)*/
+
+static	int	simd_detected = SIMD_C;	/* CPU が対応している命令セット	*/
+
+
+static const char *simd_name[ SIMD_END ] =
+{
+    "c", "sse2", "ssse3", "avx2", "neon",
+};
+
+
+int	simd_str2level(const char *str)
+{
+    int i;
+    for (i = 0; i < SIMD_END; i++) {
+	if (my_strcmp(str, simd_name[i]) == 0) {
+	    return i;
+	}
+    }
+    return -1;
+}
+
+const char *simd_level2str(int level)
+{
+    if (0 <= level && level < SIMD_END) {
+	return simd_name[ level ];
+    }
+    return "?";
+}
+
+
+/*----------------------------------------------------------------------
+ * CPU の命令セットを調べて、使用するレベルを決める
+ *	simd_register() より前に呼び出すこと
+ *----------------------------------------------------------------------*/
+void	simd_init(void)
+{
+#if	defined(SIMD_X86)
+    __builtin_cpu_init();
+    if      (__builtin_cpu_supports("avx2"))  simd_detected = SIMD_AVX2;
+    else if (__builtin_cpu_supports("ssse3")) simd_detected = SIMD_SSSE3;
+    else if (__builtin_cpu_supports("sse2"))  simd_detected = SIMD_SSE2;
+    else                                      simd_detected = SIMD_C;
+#elif	defined(SIMD_ARM)
+    simd_detected = SIMD_NEON;
+#else
+    simd_detected = SIMD_C;
+#endif
+
+    simd_level = simd_detected;
+
+    if (simd_level_force >= 0) {
+	if (simd_supports(simd_level_force)) {
+	    simd_level = simd_level_force;
+	} else {
+	    printf("-kernels %s not supported on this CPU, use %s\n",
+		   simd_level2str(simd_level_force),
+		   simd_level2str(simd_detected));
+	}
+    }
+
+    if (verbose_proc) {
+	printf("Kernels : cpu=%s, use=%s\n",
+	       simd_level2str(simd_detected), simd_level2str(simd_level));
+    }
+}
+
+
+/*----------------------------------------------------------------------
+ * 命令セット level 用のカーネルが使用可能なら、真を返す
+ *	SSE2 < SSSE3 < AVX2 は上位互換とみなす
+ *----------------------------------------------------------------------*/
+int	simd_supports(int level)
+{
+    if (level == SIMD_C) {
+	return TRUE;
+    }
+    if (level == SIMD_NEON || simd_level == SIMD_NEON) {
+	return (level == simd_level);
+    }
+    return (level <= simd_level);
+}
+
+
+/*----------------------------------------------------------------------
+ * カーネルを登録し、その場で選択させる
+ *----------------------------------------------------------------------*/
+void	simd_register(const char *name, int (*select)(void))
+{
+    int level = (select)();
+
+    if (verbose_proc) {
+	printf("  kernel %-16s : %s\n", name, simd_level2str(level));
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef SIMD_H_INCLUDED
+#define SIMD_H_INCLUDED
+
+
+/*
+ *	νŤؿ (ͥ) CPU ̿᥻åȤ˱ڤؤ
+ *
+ *	ƥͥϡ simd_register() ؿϿ롣
+ *	ؿϡsimd_supports() ǻѲǽ̿᥻åȤĴ٤ơ
+ *	Ȥδؿݥ󥿤ŬʤΤ˺ؤѤ٥֤
+ */
+
+#if	defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define	SIMD_X86				/* SSE/AVX Ǥ򥳥ѥ */
+#define	SIMD_TARGET(isa)	__attribute__((target(isa)))
+#elif	defined(__ARM_NEON) || defined(__aarch64__)
+#define	SIMD_ARM				/* NEON Ǥ򥳥ѥ    */
+#endif
+
+
+enum {
+    SIMD_C,			/* CΤ (ɤ CPU Ǥư)	*/
+    SIMD_SSE2,
+    SIMD_SSSE3,
+    SIMD_AVX2,
+    SIMD_NEON,
+    SIMD_END
+};
+
+extern	int	simd_level;		/* 򤵤줿̿᥻å		*/
+extern	int	simd_level_force;	/* -kernels Ǥλ (-1 Ǽư)*/
+
+
+int	simd_str2level(const char *str);
+const char *simd_level2str(int level);
+
+void	simd_init(void);
+int	simd_supports(int level);
+void	simd_register(const char *name, int (*select)(void));
+
+
+#endif	/* SIMD_H_INCLUDED */
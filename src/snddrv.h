@@ -74,6 +74,7 @@ int	xmame_has_mastervolume(void);
 
 int	xmame_sound_start(void);
 void	xmame_sound_update(void);
+void	xmame_sound_part_update(void);
 void	xmame_update_video_and_audio(void);
 void	xmame_sound_stop(void);
 void	xmame_sound_suspend(void);
@@ -107,12 +108,17 @@ int	xmame_cfg_get_use_samples(void);
 int	xmame_cfg_set_use_samples(int enable);
 int	xmame_cfg_get_sample_freq(void);
 int	xmame_cfg_set_sample_freq(int freq);
+int	xmame_cfg_get_sound_update(void);
 
 int	xmame_wavout_open(const char *filename);
 int	xmame_wavout_opened(void);
 void	xmame_wavout_close(void);
 int	xmame_wavout_damaged(void);
 
+bit32	xmame_audio_hash(void);
+
+int	xmame_audio_sync(int target, int frame);
+
 const char *xmame_version_mame(void);
 const char *xmame_version_fmgen(void);
 
@@ -138,6 +144,7 @@ const char *xmame_version_fmgen(void);
 
 #define	xmame_sound_start()			(TRUE)
 #define	xmame_sound_update()
+#define	xmame_sound_part_update()
 #define	xmame_update_video_and_audio()
 #define	xmame_sound_stop()
 #define	xmame_sound_suspend()
@@ -171,12 +178,17 @@ const char *xmame_version_fmgen(void);
 #define	xmame_cfg_set_use_samples(e)		(FALSE)
 #define	xmame_cfg_get_sample_freq()		(44100)
 #define	xmame_cfg_set_sample_freq(f)		(44100)
+#define	xmame_cfg_get_sound_update()		(0)
 
 #define	xmame_wavout_open(f)			(FALSE)
 #define	xmame_wavout_opened()			(FALSE)
 #define	xmame_wavout_close()
 #define	xmame_wavout_damaged()			(FALSE)
 
+#define	xmame_audio_hash()			(0)
+
+#define	xmame_audio_sync(t, f)			(-1)
+
 #define	xmame_version_mame()			""
 #define	xmame_version_fmgen()			""
 
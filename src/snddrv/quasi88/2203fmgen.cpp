@@ -16,42 +16,99 @@ extern "C" {
 #include "opna.h"
 
 
+/* register writes are queued with their position in the frame, and */
+/* applied while rendering so that each one lands on its own sample */
+#define REGQ_SIZE		1024
+#define REGQ_STAMP_ONE	(1 << 16)		/* stamp of the end of the frame */
+
+struct fmgen_regw
+{
+	int				stamp;				/* 0 .. REGQ_STAMP_ONE */
+	uint			addr;
+	uint			data;
+};
+
 struct fmgen2203_info
 {
 	sound_stream *	stream;
 	FM::OPN	*		opn;
 	uint32			last_state;
-	INT16 *			buf;
-	size_t			buf_size;
 	int				control_port_w;
+	int				render_stamp;		/* stamp the last render ended at */
+	int				regq_count;
+	struct fmgen_regw regq[REGQ_SIZE];
 };
 
 
 extern "C" {
-/* update callback from stream.c */
-static void fmgen2203_stream_update(void *param, stream_sample_t **inputs, stream_sample_t **buffer, int length)
+/* apply queued register writes without rendering */
+static void fmgen2203_regq_flush(struct fmgen2203_info *info)
 {
-	struct fmgen2203_info *info = (struct fmgen2203_info *)param;
 	int i;
-	INT16 *p;
-	stream_sample_t *bufL = buffer[0];
-	stream_sample_t *bufR = buffer[1];
-	uint32 last_count;
 
-	if (info->buf_size < length) {
-		if (info->buf) {
-			free(info->buf);
-			info->buf = NULL;
-			info->buf_size = 0;
+	for (i=0; i<info->regq_count; i++) {
+		info->opn->SetReg(info->regq[i].addr, info->regq[i].data);
+	}
+	info->regq_count = 0;
+}
+
+/* render length samples into bufL/bufR, splitting at each queued register write */
+static void fmgen2203_render(struct fmgen2203_info *info, stream_sample_t *bufL, stream_sample_t *bufR, int length)
+{
+	int now = sound_scalebufferpos(REGQ_STAMP_ONE);
+	int span, done, pos, i;
+
+	/* the frame has wrapped since the last render: render to its end */
+	if (now <= info->render_stamp) now = REGQ_STAMP_ONE;
+	span = now - info->render_stamp;
+
+	done = 0;
+	for (i=0; i<info->regq_count; i++) {
+		pos = info->regq[i].stamp - info->render_stamp;
+		if (pos <= 0) pos = 0;
+		else          pos = (int)(((UINT64)pos * length) / span);
+		if (pos > length) pos = length;
+
+		if (pos > done) {
+			info->opn->Mix(bufL + done, bufR + done, pos - done);
+			done = pos;
 		}
+		info->opn->SetReg(info->regq[i].addr, info->regq[i].data);
 	}
-	if (info->buf == NULL) {
-		info->buf = (INT16*)malloc((length + 512) * 2 * sizeof(INT16));
-		if (info->buf) {
-			info->buf_size = length + 512;
+	if (length > done) {
+		info->opn->Mix(bufL + done, bufR + done, length - done);
+	}
+
+	info->regq_count = 0;
+	info->render_stamp = (now >= REGQ_STAMP_ONE) ? 0 : now;
+}
+
+/* queue a register write, stamped with the current position in the frame */
+static void fmgen2203_write(struct fmgen2203_info *info, uint addr, uint data)
+{
+	if (info->regq_count >= REGQ_SIZE) {
+		/* render up to now; if there was nothing to render, just apply them */
+		stream_update(info->stream);
+		if (info->regq_count >= REGQ_SIZE) {
+			fmgen2203_regq_flush(info);
 		}
 	}
 
+	info->regq[info->regq_count].stamp = sound_scalebufferpos(REGQ_STAMP_ONE);
+	info->regq[info->regq_count].addr  = addr;
+	info->regq[info->regq_count].data  = data;
+	info->regq_count ++;
+}
+
+
+/* update callback from stream.c */
+static void fmgen2203_stream_update(void *param, stream_sample_t **inputs, stream_sample_t **buffer, int length)
+{
+	struct fmgen2203_info *info = (struct fmgen2203_info *)param;
+	stream_sample_t *bufL = buffer[0];
+	stream_sample_t *bufR = buffer[1];
+	uint32 last_count;
+
 	// test
 	//info->opn->Count( int(1/wait_freq_hz * 1000*1000) );
 
@@ -59,21 +116,10 @@ static void fmgen2203_stream_update(void *param, stream_sample_t **inputs, strea
 	if (last_count > 0) info->opn->Count(last_count);
 	info->last_state = 0;
 
-	if (info->buf) {
-
-		memset(info->buf, 0, (length * 2) * sizeof(INT16));
-		info->opn->Mix(info->buf, length);
-
-		p = info->buf;
-		for (i=0; i<length; i++) {
-			*bufL++ = (stream_sample_t)*p++;
-			*bufR++ = (stream_sample_t)*p++;
-		}
-
-	} else {
-		memset(bufL, 0, length * sizeof(stream_sample_t));
-		memset(bufR, 0, length * sizeof(stream_sample_t));
-	}
+	/* fmgen adds to the buffers (clipping to 16bit as before) */
+	memset(bufL, 0, length * sizeof(stream_sample_t));
+	memset(bufR, 0, length * sizeof(stream_sample_t));
+	fmgen2203_render(info, bufL, bufR, length);
 }
 
 
@@ -111,6 +157,8 @@ static void fmgen2203_reset(void *token)
 {
 	struct fmgen2203_info *info = (struct fmgen2203_info *)token;
 
+	info->regq_count = 0;
+	info->render_stamp = 0;
 	info->opn->Reset();
 }
 
@@ -181,7 +229,7 @@ WRITE8_HANDLER( FMGEN2203_write_port_0_w )
 	info->opn->Count( uint32( (total_state-info->last_state)/cpu_clock_mhz ) );
 	info->last_state = total_state;
 
-	info->opn->SetReg( info->control_port_w, data );
+	fmgen2203_write( info, info->control_port_w, data );
 }
 WRITE8_HANDLER( FMGEN2203_write_port_1_w )
 {
@@ -190,7 +238,7 @@ WRITE8_HANDLER( FMGEN2203_write_port_1_w )
 	info->opn->Count( uint32( (total_state-info->last_state)/cpu_clock_mhz ) );
 	info->last_state = total_state;
 
-	info->opn->SetReg( info->control_port_w, data );
+	fmgen2203_write( info, info->control_port_w, data );
 }
 WRITE8_HANDLER( FMGEN2203_write_port_2_w )
 {
@@ -199,7 +247,7 @@ WRITE8_HANDLER( FMGEN2203_write_port_2_w )
 	info->opn->Count( uint32( (total_state-info->last_state)/cpu_clock_mhz ) );
 	info->last_state = total_state;
 
-	info->opn->SetReg( info->control_port_w, data );
+	fmgen2203_write( info, info->control_port_w, data );
 }
 WRITE8_HANDLER( FMGEN2203_write_port_3_w )
 {
@@ -208,7 +256,7 @@ WRITE8_HANDLER( FMGEN2203_write_port_3_w )
 	info->opn->Count( uint32( (total_state-info->last_state)/cpu_clock_mhz ) );
 	info->last_state = total_state;
 
-	info->opn->SetReg( info->control_port_w, data );
+	fmgen2203_write( info, info->control_port_w, data );
 }
 WRITE8_HANDLER( FMGEN2203_write_port_4_w )
 {
@@ -217,7 +265,7 @@ WRITE8_HANDLER( FMGEN2203_write_port_4_w )
 	info->opn->Count( uint32( (total_state-info->last_state)/cpu_clock_mhz ) );
 	info->last_state = total_state;
 
-	info->opn->SetReg( info->control_port_w, data );
+	fmgen2203_write( info, info->control_port_w, data );
 }
 
 
@@ -49,6 +49,7 @@ Version 0.1, January 2002
 
 #if 1		/* QUASI88 */
 #include "audio.h"
+#include "stats.h"
 
 int	sdl_buffersize = 2048;
 
@@ -83,6 +84,9 @@ extern void *sdl_dsp_create(const void *flags);
 static void sdl_dsp_destroy(struct sysdep_dsp_struct *dsp);
 static int sdl_dsp_write(struct sysdep_dsp_struct *dsp, unsigned char *data,
    int count);
+#if 1		/* QUASI88 */
+static int sdl_dsp_get_freespace(struct sysdep_dsp_struct *dsp);
+#endif		/* QUASI88 */
 
 
 #if 0		/* QUASI88 */
@@ -134,6 +138,9 @@ extern void *sdl_dsp_create(const void *flags)
    dsp->_priv = priv;
    dsp->write = sdl_dsp_write;
    dsp->destroy = sdl_dsp_destroy;
+#if 1		/* QUASI88 */
+   dsp->get_freespace = sdl_dsp_get_freespace;
+#endif		/* QUASI88 */
    dsp->hw_info.type = params->type;
    dsp->hw_info.samplerate = params->samplerate;
     
@@ -184,6 +191,12 @@ extern void *sdl_dsp_create(const void *flags)
    		return NULL;
    }
 
+#if 1		/* QUASI88 */
+   /* the ring buffer is what get_freespace() reports on */
+   dsp->hw_info.bufsize = sample.dataSize /
+			sdl_dsp_bytes_per_sample[dsp->hw_info.type];
+#endif		/* QUASI88 */
+
    SDL_PauseAudio(0);
    
    fprintf(stderr, "info: audiodevice %s set to %dbit linear %s %dHz\n",
@@ -191,7 +204,7 @@ extern void *sdl_dsp_create(const void *flags)
       (dsp->hw_info.type & SYSDEP_DSP_STEREO)? "stereo":"mono",
       dsp->hw_info.samplerate);
       
-#if 1		/* QUASI88 */
+#if 0		/* QUASI88 */
    SDL_Delay( 500 );		/* Really Need? */
 #endif		/* QUASI88 */
    return dsp;
@@ -256,12 +269,30 @@ static int sdl_dsp_write(struct sysdep_dsp_struct *dsp, unsigned char *data,
 	return bytes_written / sdl_dsp_bytes_per_sample[dsp->hw_info.type];
 }
 
+#if 1		/* QUASI88 */
+static int sdl_dsp_get_freespace(struct sysdep_dsp_struct *dsp)
+{
+	int n;
+
+	SDL_LockAudio();
+	n = sample.dataSize - sample.sound_n_pos;
+	SDL_UnlockAudio();
+
+	return n / sdl_dsp_bytes_per_sample[dsp->hw_info.type];
+}
+#endif		/* QUASI88 */
+
+
 /* Private method */
 static void sdl_fill_sound(void *unused, Uint8 *stream, int len) 
 {
 	int result;
 	Uint8 *dst;
 	sample.amountRead = len;
+#if 1		/* QUASI88 */
+	if(sample.sound_n_pos < len)
+		STATS_INC(STATS_AUDIO_UNDERRUN);
+#endif		/* QUASI88 */
 	if(sample.sound_n_pos <= 0)
 		return;
 		
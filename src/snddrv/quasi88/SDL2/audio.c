@@ -10,6 +10,8 @@
 
 #ifdef	USE_SOUND
 
+#include <SDL2/SDL.h>
+
 #include "mame-quasi88.h"
 
 #define  SNDDRV_WORK_DEFINE
@@ -108,6 +110,9 @@ static	const	T_CONFIG_TABLE xmame_options[] =
   { 366, "close",        X_FIX,  &close_device,    TRUE,                  0,0, OPT_SAVE },
   { 366, "noclose",      X_FIX,  &close_device,    FALSE,                 0,0, OPT_SAVE },
 
+  { 367, "resample",     X_INT,  &resample_quality, 0, 2,                  0, OPT_SAVE },
+  { 368, "soundupdate",  X_INT,  &sound_update,    0, 8192,                 0, OPT_SAVE },
+
   /* 終端 */
   {   0, NULL,           X_INV,                                       0,0,0,0, 0        },
 };
@@ -149,6 +154,8 @@ void	xmame_config_show_option(void)
   "    -[no]samples / -[no]sam Use/don't use samples (if available) [-nosamples]\n"
   "    -sdlbufsize <i>         buffer size of sound stream (power of 2) [2048]\n"
   "    -[no]close              Close/no close sound device in MENU mode [-noclose]\n"
+  "    -resample <0|1|2>       Set resampling quality (0:fast 1:normal 2:high) [0]\n"
+  "    -soundupdate <i>        Send sound every <i> samples (0:every frame) [0]\n"
   );
 }
 
@@ -269,6 +276,42 @@ int		xmame_has_mastervolume(void)
 }
 
 
+/******************************************************************************
+ * サウンド出力によるウェイト調整
+ *
+ * int xmame_audio_sync(int target, int frame)
+ *      サウンドデバイスへの出力待ち (まだ再生されていない) のサンプル数が
+ *      target 以下になるまで待つ。戻値は、待つ前の出力待ちのサンプル数。
+ *      frame は 1フレーム分のサンプル数で、待つのはこの時間までとする。
+ *      出力待ちのサンプル数が分からない場合や、target に frame を加えた量が
+ *      バッファに収まらない (出力待ちが target に届かない) 場合は、待たずに
+ *      -1 を返す。
+ *
+ *      -audiosync 指定時に、タイマーによるウェイト調整の代わりに、1フレーム
+ *      処理毎に呼び出される。
+ *****************************************************************************/
+int		xmame_audio_sync(int target, int frame)
+{
+	struct sysdep_dsp_struct *dsp = sysdep_sound_dsp;
+	int queued, n, i, limit;
+
+	if (dsp == NULL || dsp->get_freespace == NULL) return -1;
+	if (target + frame > dsp->hw_info.bufsize ||
+	    dsp->hw_info.samplerate <= 0) return -1;
+
+	queued = dsp->hw_info.bufsize - dsp->get_freespace(dsp);
+
+	/* 残りはまた次のフレームで待つので、待つのは 1フレーム分までとする */
+	limit = frame * 1000 / dsp->hw_info.samplerate + 1;
+	for (n = queued, i = 0; n > target && i < limit; i++) {
+		SDL_Delay(1);
+		n = dsp->hw_info.bufsize - dsp->get_freespace(dsp);
+	}
+
+	return queued;
+}
+
+
 /*===========================================================================*/
 /*              MAME の処理関数から呼び出される、システム依存処理関数        */
 /*===========================================================================*/
@@ -301,6 +344,13 @@ int		xmame_has_mastervolume(void)
  *
  *      戻値は、 osd_start_audio_stream() と同じ
  *
+ * int osd_update_audio_stream_part(INT16 *buffer, int samples)
+ *      サウンドデバイスに、1フレームの途中までの samples 個分を出力する。
+ *      -soundupdate 指定時に、フレームの途中で呼び出される。その場合は、
+ *      フレームの残りの分も osd_update_audio_stream() ではなく、この関数で
+ *      出力される。出力したら真を返す。途中までの出力ができないなら、何も
+ *      せずに偽を返す (以降は、1フレーム毎にまとめて出力される)。
+ *
  * void osd_stop_audio_stream(void)
  *      サウンドデバイスを終了する。
  *      この関数は、エミュレーションの終了時に呼び出される。
@@ -397,6 +447,14 @@ int osd_update_audio_stream(INT16 *buffer)
 
 	return sound_samples_per_frame;
 }
+int osd_update_audio_stream_part(INT16 *buffer, int samples)
+{
+	if (sysdep_sound_dsp)
+		sysdep_sound_dsp->write(sysdep_sound_dsp, (unsigned char *)buffer,
+				samples);
+
+	return TRUE;
+}
 /*
  * xmame-0.106/src/unix/sound.c
  */
@@ -38,7 +38,7 @@ struct sysdep_dsp_struct {
    unsigned char *convert_buf;
 /* uclock_t last_update; */
    void *_priv;
-/* int (*get_freespace)(struct sysdep_dsp_struct *dsp); */
+   int (*get_freespace)(struct sysdep_dsp_struct *dsp);
    int (*write)(struct sysdep_dsp_struct *dsp, unsigned char *data,
       int count);
    void (*destroy)(struct sysdep_dsp_struct *dsp);
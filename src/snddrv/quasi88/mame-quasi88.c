@@ -19,6 +19,8 @@ int fmgenvol		= 100;		/* level of fmgen (0-100)[%] */
 int samplevol		=  50;		/* level of SAMPLE(0-100)[%] */
 int use_fmgen		= FALSE;	/* 1:use fmgen / 0:not use */
 int has_samples		= FALSE;	/* 1:use samples / 0:not use */
+int resample_quality	= 0;		/* 0:fast / 1:normal / 2:high */
+int sound_update	= 0;		/* samples per partial update (0:per frame) */
 int quasi88_is_paused = FALSE;	/* for mame_is_paused() */
 
 typedef struct {				/* list of mame-sound-I/F functions */
@@ -250,6 +252,14 @@ void	xmame_sound_update(void)
 	}
 }
 
+void	xmame_sound_part_update(void)
+{
+	if (use_sound) {
+		/* ↓ 内部で osd_update_audio_stream_part() が呼び出される */
+		sound_partial_update();
+	}
+}
+
 void	xmame_update_video_and_audio(void)
 {
 	if (use_sound) {
@@ -602,6 +612,20 @@ int		xmame_cfg_set_sample_freq(int freq)
 
 
 
+/****************************************************************
+ * 分割出力の単位 [サンプル] (0 なら 1フレーム毎)
+ ****************************************************************/
+int		xmame_cfg_get_sound_update(void)
+{
+	if (use_sound) {
+		return sound_update;
+	} else {
+		return 0;
+	}
+}
+
+
+
 /****************************************************************
  * サンプル音の使用有無
  ****************************************************************/
@@ -655,6 +679,20 @@ int		xmame_wavout_damaged(void)
 
 
 
+/****************************************************************
+ * 出力音のハッシュ値 (前回呼び出し以降の分。初回呼出でハッシュ開始)
+ ****************************************************************/
+bit32	xmame_audio_hash(void)
+{
+	if (use_sound) {
+		return sound_output_hash();
+	} else {
+		return 0;
+	}
+}
+
+
+
 /****************************************************************
  * MAMEバージョン取得関数
  ****************************************************************/
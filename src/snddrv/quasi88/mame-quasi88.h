@@ -325,6 +325,7 @@ void osd_update_video_and_audio(void);
 
 int osd_start_audio_stream(int stereo);
 int osd_update_audio_stream(INT16 *buffer);
+int osd_update_audio_stream_part(INT16 *buffer, int samples);	/* QUASI88 */
 void osd_stop_audio_stream(void);
 
 void osd_set_mastervolume(int attenuation);
@@ -386,6 +387,8 @@ extern	int fmgenvol;			/* level of fmgen  (0-100)[%] */
 extern	int samplevol;			/* level of SAMPLE (0-100)[%] */
 extern	int use_fmgen;			/* 1:use fmgen / 0:not use */
 extern	int has_samples;		/* 1:use samples / 0:not use */
+extern	int resample_quality;	/* 0:fast / 1:normal / 2:high */
+extern	int sound_update;		/* samples per partial update (0:per frame) */
 extern	int quasi88_is_paused;	/* for mame_is_paused() */
 
 #endif		/* MAME_QUASI88_H_INCLUDED */
@@ -0,0 +1,404 @@
+/***************************************************************************
+
+    sndsimd.c
+
+    SIMD kernels for the sound mixing path (QUASI88).
+
+    Each kernel has a plain C version and, where the compiler allows it,
+    SSE2/AVX2/NEON versions. The variant is chosen once at startup by the
+    dispatch layer in simd.c (see -kernels and -verbose).
+
+***************************************************************************/
+
+#include "driver.h"
+#include "simd.h"
+#include "sndsimd.h"
+
+#if defined(SIMD_X86)
+#include <immintrin.h>
+#elif defined(SIMD_ARM)
+#include <arm_neon.h>
+#endif
+
+
+
+/***************************************************************************
+    MIX SUM
+***************************************************************************/
+
+static void mix_sum_c(stream_sample_t *dst, stream_sample_t **inputs, int numinputs, int length)
+{
+	int pos, inp;
+
+	for (pos = 0; pos < length; pos++)
+	{
+		INT32 sample = inputs[0][pos];
+
+		for (inp = 1; inp < numinputs; inp++)
+			sample += inputs[inp][pos];
+		dst[pos] = sample;
+	}
+}
+
+#if defined(SIMD_X86)
+
+SIMD_TARGET("sse2")
+static void mix_sum_sse2(stream_sample_t *dst, stream_sample_t **inputs, int numinputs, int length)
+{
+	int pos = 0, inp;
+
+	for ( ; pos + 4 <= length; pos += 4)
+	{
+		__m128i sum = _mm_loadu_si128((const __m128i *)&inputs[0][pos]);
+
+		for (inp = 1; inp < numinputs; inp++)
+			sum = _mm_add_epi32(sum, _mm_loadu_si128((const __m128i *)&inputs[inp][pos]));
+		_mm_storeu_si128((__m128i *)&dst[pos], sum);
+	}
+	for ( ; pos < length; pos++)
+	{
+		INT32 sample = inputs[0][pos];
+
+		for (inp = 1; inp < numinputs; inp++)
+			sample += inputs[inp][pos];
+		dst[pos] = sample;
+	}
+}
+
+SIMD_TARGET("avx2")
+static void mix_sum_avx2(stream_sample_t *dst, stream_sample_t **inputs, int numinputs, int length)
+{
+	int pos = 0, inp;
+
+	for ( ; pos + 8 <= length; pos += 8)
+	{
+		__m256i sum = _mm256_loadu_si256((const __m256i *)&inputs[0][pos]);
+
+		for (inp = 1; inp < numinputs; inp++)
+			sum = _mm256_add_epi32(sum, _mm256_loadu_si256((const __m256i *)&inputs[inp][pos]));
+		_mm256_storeu_si256((__m256i *)&dst[pos], sum);
+	}
+	for ( ; pos < length; pos++)
+	{
+		INT32 sample = inputs[0][pos];
+
+		for (inp = 1; inp < numinputs; inp++)
+			sample += inputs[inp][pos];
+		dst[pos] = sample;
+	}
+}
+
+#elif defined(SIMD_ARM)
+
+static void mix_sum_neon(stream_sample_t *dst, stream_sample_t **inputs, int numinputs, int length)
+{
+	int pos = 0, inp;
+
+	for ( ; pos + 4 <= length; pos += 4)
+	{
+		int32x4_t sum = vld1q_s32(&inputs[0][pos]);
+
+		for (inp = 1; inp < numinputs; inp++)
+			sum = vaddq_s32(sum, vld1q_s32(&inputs[inp][pos]));
+		vst1q_s32(&dst[pos], sum);
+	}
+	for ( ; pos < length; pos++)
+	{
+		INT32 sample = inputs[0][pos];
+
+		for (inp = 1; inp < numinputs; inp++)
+			sample += inputs[inp][pos];
+		dst[pos] = sample;
+	}
+}
+
+#endif
+
+void (*sndsimd_mix_sum)(stream_sample_t *dst, stream_sample_t **inputs, int numinputs, int length) = mix_sum_c;
+
+static int mix_sum_select(void)
+{
+#if defined(SIMD_X86)
+	if (simd_supports(SIMD_AVX2)) { sndsimd_mix_sum = mix_sum_avx2; return SIMD_AVX2; }
+	if (simd_supports(SIMD_SSE2)) { sndsimd_mix_sum = mix_sum_sse2; return SIMD_SSE2; }
+#elif defined(SIMD_ARM)
+	if (simd_supports(SIMD_NEON)) { sndsimd_mix_sum = mix_sum_neon; return SIMD_NEON; }
+#endif
+	sndsimd_mix_sum = mix_sum_c;
+	return SIMD_C;
+}
+
+
+
+/***************************************************************************
+    MIX FINAL (route the speakers with their gains, clamp to 16 bits and
+    interleave left/right)
+
+    All variants sum in float in the same order and truncate after the
+    clamp, so they produce identical output.
+***************************************************************************/
+
+static void mix_final_range(INT16 *dst, const stream_sample_t * const *src, const float *gain, int numsrc, int start, int length)
+{
+	int sample, spk;
+
+	for (sample = start; sample < length; sample++)
+	{
+		float left = 0, right = 0;
+
+		for (spk = 0; spk < numsrc; spk++)
+		{
+			float samp = (float)src[spk][sample];
+
+			left += samp * gain[spk*2+0];
+			right += samp * gain[spk*2+1];
+		}
+
+		/* clamp the left side */
+		if (left < -32768.0f)
+			left = -32768.0f;
+		else if (left > 32767.0f)
+			left = 32767.0f;
+		dst[sample*2+0] = (INT16)left;
+
+		/* clamp the right side */
+		if (right < -32768.0f)
+			right = -32768.0f;
+		else if (right > 32767.0f)
+			right = 32767.0f;
+		dst[sample*2+1] = (INT16)right;
+	}
+}
+
+static void mix_final_c(INT16 *dst, const stream_sample_t * const *src, const float *gain, int numsrc, int length)
+{
+	mix_final_range(dst, src, gain, numsrc, 0, length);
+}
+
+#if defined(SIMD_X86)
+
+SIMD_TARGET("sse2")
+static void mix_final_sse2(INT16 *dst, const stream_sample_t * const *src, const float *gain, int numsrc, int length)
+{
+	const __m128 lo = _mm_set1_ps(-32768.0f), hi = _mm_set1_ps(32767.0f);
+	int sample = 0, spk;
+
+	for ( ; sample + 4 <= length; sample += 4)
+	{
+		__m128 l = _mm_setzero_ps(), r = _mm_setzero_ps();
+		__m128i li, ri;
+
+		for (spk = 0; spk < numsrc; spk++)
+		{
+			__m128 samp = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)&src[spk][sample]));
+
+			l = _mm_add_ps(l, _mm_mul_ps(samp, _mm_set1_ps(gain[spk*2+0])));
+			r = _mm_add_ps(r, _mm_mul_ps(samp, _mm_set1_ps(gain[spk*2+1])));
+		}
+		li = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(l, lo), hi));
+		ri = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(r, lo), hi));
+
+		_mm_storeu_si128((__m128i *)&dst[sample*2],
+				_mm_packs_epi32(_mm_unpacklo_epi32(li, ri), _mm_unpackhi_epi32(li, ri)));
+	}
+	mix_final_range(dst, src, gain, numsrc, sample, length);
+}
+
+SIMD_TARGET("avx2")
+static void mix_final_avx2(INT16 *dst, const stream_sample_t * const *src, const float *gain, int numsrc, int length)
+{
+	const __m256 lo = _mm256_set1_ps(-32768.0f), hi = _mm256_set1_ps(32767.0f);
+	int sample = 0, spk;
+
+	/* unpack/packs work within each 128-bit lane, which keeps the order */
+	for ( ; sample + 8 <= length; sample += 8)
+	{
+		__m256 l = _mm256_setzero_ps(), r = _mm256_setzero_ps();
+		__m256i li, ri;
+
+		for (spk = 0; spk < numsrc; spk++)
+		{
+			__m256 samp = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)&src[spk][sample]));
+
+			l = _mm256_add_ps(l, _mm256_mul_ps(samp, _mm256_set1_ps(gain[spk*2+0])));
+			r = _mm256_add_ps(r, _mm256_mul_ps(samp, _mm256_set1_ps(gain[spk*2+1])));
+		}
+		li = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(l, lo), hi));
+		ri = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(r, lo), hi));
+
+		_mm256_storeu_si256((__m256i *)&dst[sample*2],
+				_mm256_packs_epi32(_mm256_unpacklo_epi32(li, ri), _mm256_unpackhi_epi32(li, ri)));
+	}
+	mix_final_range(dst, src, gain, numsrc, sample, length);
+}
+
+#elif defined(SIMD_ARM)
+
+static void mix_final_neon(INT16 *dst, const stream_sample_t * const *src, const float *gain, int numsrc, int length)
+{
+	const float32x4_t lo = vdupq_n_f32(-32768.0f), hi = vdupq_n_f32(32767.0f);
+	int sample = 0, spk;
+
+	for ( ; sample + 4 <= length; sample += 4)
+	{
+		float32x4_t l = vdupq_n_f32(0), r = vdupq_n_f32(0);
+		int16x4x2_t lr;
+
+		/* separate multiply and add, so that the result matches the C version */
+		for (spk = 0; spk < numsrc; spk++)
+		{
+			float32x4_t samp = vcvtq_f32_s32(vld1q_s32(&src[spk][sample]));
+
+			l = vaddq_f32(l, vmulq_n_f32(samp, gain[spk*2+0]));
+			r = vaddq_f32(r, vmulq_n_f32(samp, gain[spk*2+1]));
+		}
+		lr.val[0] = vmovn_s32(vcvtq_s32_f32(vminq_f32(vmaxq_f32(l, lo), hi)));
+		lr.val[1] = vmovn_s32(vcvtq_s32_f32(vminq_f32(vmaxq_f32(r, lo), hi)));
+		vst2_s16(&dst[sample*2], lr);
+	}
+	mix_final_range(dst, src, gain, numsrc, sample, length);
+}
+
+#endif
+
+void (*sndsimd_mix_final)(INT16 *dst, const stream_sample_t * const *src, const float *gain, int numsrc, int length) = mix_final_c;
+
+static int mix_final_select(void)
+{
+#if defined(SIMD_X86)
+	if (simd_supports(SIMD_AVX2)) { sndsimd_mix_final = mix_final_avx2; return SIMD_AVX2; }
+	if (simd_supports(SIMD_SSE2)) { sndsimd_mix_final = mix_final_sse2; return SIMD_SSE2; }
+#elif defined(SIMD_ARM)
+	if (simd_supports(SIMD_NEON)) { sndsimd_mix_final = mix_final_neon; return SIMD_NEON; }
+#endif
+	sndsimd_mix_final = mix_final_c;
+	return SIMD_C;
+}
+
+
+
+/***************************************************************************
+    POLYPHASE FIR RESAMPLER
+***************************************************************************/
+
+#define FIR_SETUP(pos)														\
+	const stream_sample_t *src = source + ((pos) >> frac_bits);				\
+	const float *c = coef + (((pos) & frac_mask) >> phase_shift) * taps
+
+static void resample_fir_c(stream_sample_t *dest, const stream_sample_t *source, UINT32 pos, UINT32 step, int frac_bits, const float *coef, int taps, INT32 gain, int samples)
+{
+	UINT32 frac_mask = (1 << frac_bits) - 1;
+	int phase_shift = frac_bits - SNDSIMD_FIR_PHASE_BITS;
+
+	while (samples--)
+	{
+		FIR_SETUP(pos);
+		float acc = 0;
+		int k;
+
+		for (k = 0; k < taps; k++)
+			acc += src[k] * c[k];
+		*dest++ = ((INT32)acc * gain) >> 8;
+		pos += step;
+	}
+}
+
+#if defined(SIMD_X86)
+
+SIMD_TARGET("sse2")
+static void resample_fir_sse2(stream_sample_t *dest, const stream_sample_t *source, UINT32 pos, UINT32 step, int frac_bits, const float *coef, int taps, INT32 gain, int samples)
+{
+	UINT32 frac_mask = (1 << frac_bits) - 1;
+	int phase_shift = frac_bits - SNDSIMD_FIR_PHASE_BITS;
+
+	while (samples--)
+	{
+		FIR_SETUP(pos);
+		__m128 acc = _mm_setzero_ps();
+		int k;
+
+		for (k = 0; k < taps; k += 4)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)&src[k])), _mm_loadu_ps(&c[k])));
+		acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+		acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+		*dest++ = ((INT32)_mm_cvtss_f32(acc) * gain) >> 8;
+		pos += step;
+	}
+}
+
+SIMD_TARGET("avx2")
+static void resample_fir_avx2(stream_sample_t *dest, const stream_sample_t *source, UINT32 pos, UINT32 step, int frac_bits, const float *coef, int taps, INT32 gain, int samples)
+{
+	UINT32 frac_mask = (1 << frac_bits) - 1;
+	int phase_shift = frac_bits - SNDSIMD_FIR_PHASE_BITS;
+
+	while (samples--)
+	{
+		FIR_SETUP(pos);
+		__m256 acc8 = _mm256_setzero_ps();
+		__m128 acc;
+		int k;
+
+		for (k = 0; k < taps; k += 8)
+			acc8 = _mm256_add_ps(acc8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)&src[k])), _mm256_loadu_ps(&c[k])));
+		acc = _mm_add_ps(_mm256_castps256_ps128(acc8), _mm256_extractf128_ps(acc8, 1));
+		acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+		acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+		*dest++ = ((INT32)_mm_cvtss_f32(acc) * gain) >> 8;
+		pos += step;
+	}
+}
+
+#elif defined(SIMD_ARM)
+
+static void resample_fir_neon(stream_sample_t *dest, const stream_sample_t *source, UINT32 pos, UINT32 step, int frac_bits, const float *coef, int taps, INT32 gain, int samples)
+{
+	UINT32 frac_mask = (1 << frac_bits) - 1;
+	int phase_shift = frac_bits - SNDSIMD_FIR_PHASE_BITS;
+
+	while (samples--)
+	{
+		FIR_SETUP(pos);
+		float32x4_t acc = vdupq_n_f32(0);
+		float32x2_t sum;
+		int k;
+
+		for (k = 0; k < taps; k += 4)
+			acc = vmlaq_f32(acc, vcvtq_f32_s32(vld1q_s32(&src[k])), vld1q_f32(&c[k]));
+		sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+		sum = vpadd_f32(sum, sum);
+		*dest++ = ((INT32)vget_lane_f32(sum, 0) * gain) >> 8;
+		pos += step;
+	}
+}
+
+#endif
+
+#undef FIR_SETUP
+
+void (*sndsimd_resample_fir)(stream_sample_t *dest, const stream_sample_t *source, UINT32 pos, UINT32 step, int frac_bits, const float *coef, int taps, INT32 gain, int samples) = resample_fir_c;
+
+static int resample_fir_select(void)
+{
+#if defined(SIMD_X86)
+	if (simd_supports(SIMD_AVX2)) { sndsimd_resample_fir = resample_fir_avx2; return SIMD_AVX2; }
+	if (simd_supports(SIMD_SSE2)) { sndsimd_resample_fir = resample_fir_sse2; return SIMD_SSE2; }
+#elif defined(SIMD_ARM)
+	if (simd_supports(SIMD_NEON)) { sndsimd_resample_fir = resample_fir_neon; return SIMD_NEON; }
+#endif
+	sndsimd_resample_fir = resample_fir_c;
+	return SIMD_C;
+}
+
+
+
+/***************************************************************************
+    REGISTRATION
+***************************************************************************/
+
+void sndsimd_init(void)
+{
+	simd_register("mixer_sum", mix_sum_select);
+	simd_register("mixer_final", mix_final_select);
+	simd_register("resample_fir", resample_fir_select);
+}
@@ -0,0 +1,33 @@
+/***************************************************************************
+
+    sndsimd.h
+
+    SIMD kernels for the sound mixing path (QUASI88).
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __SNDSIMD_H__
+#define __SNDSIMD_H__
+
+
+/* dst[pos] = inputs[0][pos] + ... + inputs[numinputs-1][pos] */
+extern void (*sndsimd_mix_sum)(stream_sample_t *dst, stream_sample_t **inputs, int numinputs, int length);
+
+/* dst[pos*2+0] = clamp(sum of src[n][pos] * gain[n*2+0]), */
+/* dst[pos*2+1] = clamp(sum of src[n][pos] * gain[n*2+1])  */
+extern void (*sndsimd_mix_final)(INT16 *dst, const stream_sample_t * const *src, const float *gain, int numsrc, int length);
+
+/* polyphase FIR resampler; coef holds (1 << SNDSIMD_FIR_PHASE_BITS) phases of */
+/* taps coefficients each, taps is a multiple of SNDSIMD_FIR_TAPS_ALIGN */
+#define SNDSIMD_FIR_PHASE_BITS		8
+#define SNDSIMD_FIR_TAPS_ALIGN		8
+
+extern void (*sndsimd_resample_fir)(stream_sample_t *dest, const stream_sample_t *source, UINT32 pos, UINT32 step, int frac_bits, const float *coef, int taps, INT32 gain, int samples);
+
+
+void sndsimd_init(void);
+
+
+#endif	/* __SNDSIMD_H__ */
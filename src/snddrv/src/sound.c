@@ -19,6 +19,7 @@
 #else		/* QUASI88 */
 #include "wavwrite.h"
 #endif		/* QUASI88 */
+#include "sndsimd.h"	/* QUASI88 */
 
 
 
@@ -82,6 +83,9 @@ struct _speaker_info
 	sound_stream *	mixer_stream;			/* mixing stream */
 	int				inputs;					/* number of input streams */
 	speaker_input *	input;					/* array of input information */
+#if 1		/* QUASI88 */
+	float			gain[2];				/* left/right gain (routing folded in) */
+#endif		/* QUASI88 */
 #ifdef MAME_DEBUG
 	INT32			max_sample;				/* largest sample value we've seen */
 	INT32			clipped_samples;		/* total number of clipped samples */
@@ -104,13 +108,37 @@ static int totalspeakers;
 static speaker_info speaker[MAX_SPEAKER];
 
 static INT16 *finalmix;
+#if 0		/* QUASI88 */
 static INT32 *leftmix, *rightmix;
+#endif		/* QUASI88 */
 static int samples_this_frame;
+#if 1		/* QUASI88 */
+static int samples_mixed;		/* samples of this frame already mixed into finalmix */
+static int samples_sent;		/* samples of this frame already passed to the OSD layer */
+static int partial_disabled;	/* the OSD layer can't take partial output */
+#endif		/* QUASI88 */
 static int global_sound_enabled;
 static int nosound_mode;
 
 static wav_file *wavfile;
 
+#if	1		/* QUASI88 */
+static int output_hash_enable;
+static UINT32 output_hash;
+
+static void output_hash_add(const INT16 *data, int count)
+{
+	UINT32 h = output_hash;
+	while (count--)
+	{
+		UINT16 s = (UINT16)*data++;
+		h = (h ^ (s & 0xff)) * 16777619u;
+		h = (h ^ (s >> 8)) * 16777619u;
+	}
+	output_hash = h;
+}
+#endif		/* QUASI88 */
+
 
 
 /***************************************************************************
@@ -196,12 +224,22 @@ int sound_init(void)
 	samples_this_frame = osd_start_audio_stream(1);
 	if (!samples_this_frame)
 		return 1;
+#if 1		/* QUASI88 */
+	samples_mixed = 0;
+	samples_sent = 0;
+	partial_disabled = FALSE;
+#endif		/* QUASI88 */
 
 	/* allocate memory for mix buffers */
+#if 0		/* QUASI88 */
 	leftmix = auto_malloc(Machine->sample_rate * sizeof(*leftmix));
 	rightmix = auto_malloc(Machine->sample_rate * sizeof(*rightmix));
+#endif		/* QUASI88 */
 	finalmix = auto_malloc(Machine->sample_rate * sizeof(*finalmix));
 
+	/* select the mixing kernels for this CPU */	/* QUASI88 */
+	sndsimd_init();
+
 	/* allocate a global timer for sound timing */
 	sound_update_timer = mame_timer_alloc(NULL);
 
@@ -422,6 +460,11 @@ static int start_speakers(void)
 		info->speaker = mspeaker;
 		info->mixer_stream = NULL;
 		info->inputs = 0;
+#if 1		/* QUASI88 */
+		/* centered speakers go to both sides, others to one side only */
+		info->gain[0] = (mspeaker->x <= 0) ? 1.0f : 0.0f;
+		info->gain[1] = (mspeaker->x >= 0) ? 1.0f : 0.0f;
+#endif		/* QUASI88 */
 	}
 	return 0;
 }
@@ -667,14 +710,112 @@ static void sound_save(int config_type, xml_data_node *parentnode)
     its final form and send it to the OSD layer
 -------------------------------------------------*/
 
+#if 1		/* QUASI88 */
+/*-------------------------------------------------
+    mix_speakers - mix the next 'samples' samples
+    of every speaker into finalmix, starting at
+    sample 'start' of this frame
+-------------------------------------------------*/
+
+static void mix_speakers(int start, int samples)
+{
+	int spknum;
+#ifdef MAME_DEBUG
+	int sample;
+#endif
+	const stream_sample_t *mixsrc[MAX_SPEAKER];
+	float mixgain[MAX_SPEAKER * 2];
+	int nummix = 0;
+
+	/* if we're not paused, keep the sounds going */
+	if (!mame_is_paused(Machine))
+	{
+		/* force all the speaker streams to generate the proper number of samples */
+		for (spknum = 0; spknum < totalspeakers; spknum++)
+		{
+			speaker_info *spk = &speaker[spknum];
+			stream_sample_t *stream_buf;
+
+			/* get the output buffer */
+			if (spk->mixer_stream)
+			{
+				stream_buf = stream_consume_output(spk->mixer_stream, 0, samples);
+
+#ifdef MAME_DEBUG
+				/* debug version: keep track of the maximum sample */
+				for (sample = 0; sample < samples; sample++)
+				{
+					if (stream_buf[sample] > spk->max_sample)
+						spk->max_sample = stream_buf[sample];
+					else if (-stream_buf[sample] > spk->max_sample)
+						spk->max_sample = -stream_buf[sample];
+					if (stream_buf[sample] > 32767 || stream_buf[sample] < -32768)
+						spk->clipped_samples++;
+					spk->total_samples++;
+				}
+#endif
+
+				/* collect the speakers if sound is enabled; they are mixed in one pass below */
+				if (global_sound_enabled && !nosound_mode)
+				{
+					mixsrc[nummix] = stream_buf;
+					mixgain[nummix*2+0] = spk->gain[0];
+					mixgain[nummix*2+1] = spk->gain[1];
+					nummix++;
+				}
+			}
+		}
+	}
+
+	/* route, clamp and interleave straight into finalmix */
+	sndsimd_mix_final(finalmix + start * 2, mixsrc, mixgain, nummix, samples);
+}
+
+
+/*-------------------------------------------------
+    sound_partial_update - mix the samples up to
+    the current position within the frame and
+    send them to the OSD layer right away
+-------------------------------------------------*/
+
+void sound_partial_update(void)
+{
+	int pos;
+
+	if (partial_disabled || mame_is_paused(Machine))
+		return;
+
+	pos = sound_scalebufferpos(samples_this_frame);
+	if (pos <= samples_mixed)
+		return;
+
+	profiler_mark(PROFILER_SOUND);
+
+	mix_speakers(samples_mixed, pos - samples_mixed);
+	samples_mixed = pos;
+
+	/* if the OSD layer can't take it, the whole frame goes out at the end as before */
+	if (osd_update_audio_stream_part(finalmix + samples_sent * 2, samples_mixed - samples_sent))
+		samples_sent = samples_mixed;
+	else
+		partial_disabled = TRUE;
+
+	profiler_mark(PROFILER_END);
+}
+#endif		/* QUASI88 */
+
+
 void sound_frame_update(void)
 {
+#if 0		/* QUASI88 */
 	int sample, spknum;
+#endif		/* QUASI88 */
 
 	VPRINTF(("sound_frame_update\n"));
 
 	profiler_mark(PROFILER_SOUND);
 
+#if 0		/* QUASI88 */
 	/* reset the mixing streams */
 	memset(leftmix, 0, samples_this_frame * sizeof(*leftmix));
 	memset(rightmix, 0, samples_this_frame * sizeof(*rightmix));
@@ -753,12 +894,30 @@ void sound_frame_update(void)
 			samp = 32767;
 		finalmix[sample*2+1] = samp;
 	}
+#else		/* QUASI88 */
+	/* mix what the partial updates haven't yet */
+	mix_speakers(samples_mixed, samples_this_frame - samples_mixed);
+#endif		/* QUASI88 */
 
 	if (wavfile && !mame_is_paused(Machine))
 		wav_add_data_16(wavfile, finalmix, samples_this_frame * 2);
 
+#if	1		/* QUASI88 */
+	if (output_hash_enable)
+		output_hash_add(finalmix, samples_this_frame * 2);
+#endif		/* QUASI88 */
+
 	/* play the result */
+#if 0		/* QUASI88 */
 	samples_this_frame = osd_update_audio_stream(finalmix);
+#else		/* QUASI88 */
+	if (samples_sent == 0)
+		samples_this_frame = osd_update_audio_stream(finalmix);
+	else
+		osd_update_audio_stream_part(finalmix + samples_sent * 2, samples_this_frame - samples_sent);
+	samples_mixed = 0;
+	samples_sent = 0;
+#endif		/* QUASI88 */
 
 	/* update the streamer */
 	streams_frame_update();
@@ -778,10 +937,13 @@ static void mixer_update(void *param, stream_sample_t **inputs, stream_sample_t
 {
 	speaker_info *speaker = param;
 	int numinputs = speaker->inputs;
+#if 0		/* QUASI88 */
 	int pos;
+#endif		/* QUASI88 */
 
 	VPRINTF(("Mixer_update(%d)\n", length));
 
+#if 0		/* QUASI88 */
 	/* loop over samples */
 	for (pos = 0; pos < length; pos++)
 	{
@@ -793,6 +955,10 @@ static void mixer_update(void *param, stream_sample_t **inputs, stream_sample_t
 			sample += inputs[inp][pos];
 		buffer[0][pos] = sample;
 	}
+#else		/* QUASI88 */
+	/* add up all the inputs */
+	sndsimd_mix_sum(buffer[0], inputs, numinputs, length);
+#endif		/* QUASI88 */
 }
 
 
@@ -965,6 +1131,17 @@ const char *sound_get_user_gain_name(int index)
 
 
 #if	1		/* QUASI88 */
+/* returns FNV-1a hash of the mixed output since the previous call
+   (hashing is off until the first call) */
+UINT32 sound_output_hash(void)
+{
+	UINT32 h = output_hash;
+
+	output_hash_enable = TRUE;
+	output_hash = 2166136261u;
+	return h;
+}
+
 static	int	wavfile_sample_rate;
 
 int sound_wavfile_open(const char *filename)
@@ -79,6 +79,8 @@ int sound_wavfile_open(const char *filename);
 int sound_wavfile_opened(void);
 void sound_wavfile_close(void);
 int sound_wavfile_damaged(void);
+UINT32 sound_output_hash(void);
+void sound_partial_update(void);
 #endif		/* QUASI88 */
 void sound_frame_update(void);
 int sound_scalebufferpos(int value);
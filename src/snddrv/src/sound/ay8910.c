@@ -290,6 +290,24 @@ WRITE16_HANDLER( AY8910_write_port_4_msb_w ) { if (ACCESSING_MSB) ay8910_write_y
 
 
 
+#if 1		/* QUASI88 */
+/* Number of samples (up to length) before the next tone, noise or envelope */
+/* event. Within that run every square wave stays in its current state for */
+/* the whole sample period, so the output is constant. */
+static int AY8910RunLength(struct AY8910 *PSG,int length)
+{
+	int run = length;
+
+	if ((PSG->CountA - 1) / STEP < run) run = (PSG->CountA - 1) / STEP;
+	if ((PSG->CountB - 1) / STEP < run) run = (PSG->CountB - 1) / STEP;
+	if ((PSG->CountC - 1) / STEP < run) run = (PSG->CountC - 1) / STEP;
+	if ((PSG->CountN - 1) / STEP < run) run = (PSG->CountN - 1) / STEP;
+	if (PSG->Holding == 0 && (PSG->CountE - 1) / STEP < run) run = (PSG->CountE - 1) / STEP;
+
+	return run;
+}
+#endif
+
 static void AY8910Update(void *param,stream_sample_t **inputs, stream_sample_t **buffer,int length)
 {
 	struct AY8910 *PSG = param;
@@ -375,6 +393,44 @@ static void AY8910Update(void *param,stream_sample_t **inputs, stream_sample_t *
 		int vola,volb,volc;
 		int left;
 
+#if 1		/* QUASI88 */
+		/* emit a run of constant output without stepping the generators */
+		left = AY8910RunLength(PSG, length);
+		if (left > 0)
+		{
+			int i;
+
+			vola = ((outn & 0x08) && PSG->OutputA) ? PSG->VolA : 0;
+			volb = ((outn & 0x10) && PSG->OutputB) ? PSG->VolB : 0;
+			volc = ((outn & 0x20) && PSG->OutputC) ? PSG->VolC : 0;
+
+			if (PSG->streams == 3)
+			{
+				for (i = 0; i < left; i++) buf1[i] = vola;
+				for (i = 0; i < left; i++) buf2[i] = volb;
+				for (i = 0; i < left; i++) buf3[i] = volc;
+				buf2 += left;
+				buf3 += left;
+			}
+			else
+			{
+				vola += volb + volc;
+				for (i = 0; i < left; i++) buf1[i] = vola;
+			}
+			buf1 += left;
+
+			PSG->CountA -= left * STEP;
+			PSG->CountB -= left * STEP;
+			PSG->CountC -= left * STEP;
+			PSG->CountN -= left * STEP;
+			if (PSG->Holding == 0)
+				PSG->CountE -= left * STEP;
+
+			length -= left;
+			continue;
+		}
+#endif
+
 
 		/* vola, volb and volc keep track of how long each square wave stays */
 		/* in the 1 position during the sample period. */
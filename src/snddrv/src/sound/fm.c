@@ -1256,12 +1256,33 @@ INLINE void advance_eg_channel(FM_OPN *OPN, FM_SLOT *SLOT)
 
 #define volume_calc(OP) ((OP)->vol_out + (AM & (OP)->AMmask))
 
+#if 1	/* QUASI88 */
+INLINE void chan_update_phase(FM_OPN *OPN, FM_CH *CH);
+
+/* A channel is silent when every slot is attenuated by ENV_QUIET or more (AM only adds
+   attenuation) and nothing is left in the feedback and MEM delay lines.
+   chan_calc() would then add nothing to the output and leave op1_out[] and
+   mem_value at zero, so only the phase counters need to move on. */
+#define chan_is_silent(CH)							\
+	((CH)->op1_out[0] == 0 && (CH)->op1_out[1] == 0 && (CH)->mem_value == 0 &&	\
+	 (CH)->SLOT[SLOT1].vol_out >= ENV_QUIET && (CH)->SLOT[SLOT2].vol_out >= ENV_QUIET &&	\
+	 (CH)->SLOT[SLOT3].vol_out >= ENV_QUIET && (CH)->SLOT[SLOT4].vol_out >= ENV_QUIET)
+#endif	/* QUASI88 */
+
 INLINE void chan_calc(FM_OPN *OPN, FM_CH *CH)
 {
 	unsigned int eg_out;
 
 	UINT32 AM = LFO_AM >> CH->ams;
 
+#if 1	/* QUASI88 */
+	if (chan_is_silent(CH))
+	{
+		chan_update_phase(OPN, CH);
+		return;
+	}
+#endif	/* QUASI88 */
+
 
 	m2 = c1 = c2 = mem = 0;
 
@@ -1307,6 +1328,13 @@ INLINE void chan_calc(FM_OPN *OPN, FM_CH *CH)
 	CH->mem_value = mem;
 
 	/* update phase counters AFTER output calculations */
+#if 1	/* QUASI88 */
+	chan_update_phase(OPN, CH);
+}
+
+INLINE void chan_update_phase(FM_OPN *OPN, FM_CH *CH)
+{
+#endif	/* QUASI88 */
 	if(CH->pms)
 	{
 
@@ -3468,6 +3496,9 @@ void YM2608Shutdown(void *chip)
 	YM2608 *F2608 = chip;
 
 	FMCloseTable();
+#if 1	/* QUASI88 */
+	YM_DELTAT_cache_free(&F2608->deltaT);
+#endif	/* QUASI88 */
 	free(F2608);
 }
 
@@ -4148,6 +4179,9 @@ void YM2610Shutdown(void *chip)
 	YM2610 *F2610 = chip;
 
 	FMCloseTable();
+#if 1	/* QUASI88 */
+	YM_DELTAT_cache_free(&F2610->deltaT);
+#endif	/* QUASI88 */
 	free(F2610);
 }
 
@@ -150,6 +150,123 @@ UINT8 YM_DELTAT_ADPCM_Read(YM_DELTAT *DELTAT)
 }
 
 
+#if 1	/* QUASI88 */
+/*
+  ADPCM decode cache
+
+  Games replay the same samples from external memory many times, and each
+  playback decodes every nibble again from the start address. The acc and
+  adpcmd values after each nibble are kept per start address and replayed
+  on the next playback. The address walk (end, limit, repeat) is still done
+  as usual; only the decode is skipped.
+
+  Each entry also keeps the source bytes and compares them with the memory
+  as it goes. If they differ (the memory was rewritten via $08, or restored
+  by a state load), the entry is truncated there and decoding continues.
+*/
+
+/* select (or allocate) the entry for the sample starting now */
+static void ym_deltat_cache_select(YM_DELTAT *DELTAT)
+{
+	YM_DELTAT_CACHE *cache, *lru = &DELTAT->cache[0];
+	int i;
+
+	for (i = 0; i < YM_DELTAT_CACHE_NR; i++)
+	{
+		cache = &DELTAT->cache[i];
+		if (cache->length && cache->start == DELTAT->start)
+		{
+			lru = cache;
+			break;
+		}
+		if (cache->length == 0 || (lru->length && cache->used < lru->used))
+			lru = cache;
+	}
+	if (i == YM_DELTAT_CACHE_NR)
+	{
+		lru->start  = DELTAT->start;
+		lru->length = 0;
+	}
+
+	lru->used = ++DELTAT->cache_stamp;
+	DELTAT->cache_now = lru;
+	DELTAT->cache_pos = 0;
+}
+
+/* append the nibble just decoded from the byte at addr */
+static void ym_deltat_cache_store(YM_DELTAT *DELTAT, UINT32 addr)
+{
+	YM_DELTAT_CACHE *cache = DELTAT->cache_now;
+	UINT32 pos = DELTAT->cache_pos;
+
+	if (pos >= cache->size)
+	{
+		UINT32 size = (cache->size) ? cache->size * 2 : 0x1000;
+		INT16 *acc, *adpcmd;
+		UINT8 *src;
+
+		/* sample longer than the memory : it is looping via limit */
+		if (size > DELTAT->memory_size * 2)
+		{
+			DELTAT->cache_now = NULL;
+			return;
+		}
+		acc    = realloc(cache->acc,    size * sizeof(INT16));
+		if (acc) cache->acc = acc;
+		adpcmd = realloc(cache->adpcmd, size * sizeof(INT16));
+		if (adpcmd) cache->adpcmd = adpcmd;
+		src    = realloc(cache->src,    size / 2);
+		if (src) cache->src = src;
+		if (acc == NULL || adpcmd == NULL || src == NULL)
+		{
+			DELTAT->cache_now = NULL;
+			return;
+		}
+		cache->size = size;
+	}
+
+	if (pos == 0 || addr < cache->lo) cache->lo = addr;
+	if (pos == 0 || addr > cache->hi) cache->hi = addr;
+
+	cache->acc[pos]    = DELTAT->acc;
+	cache->adpcmd[pos] = DELTAT->adpcmd;
+	if ((pos & 1) == 0) cache->src[pos >> 1] = DELTAT->now_data;
+
+	cache->length = DELTAT->cache_pos = pos + 1;
+}
+
+/* the byte at addr was written : drop the entries containing it */
+static void ym_deltat_cache_written(YM_DELTAT *DELTAT, UINT32 addr)
+{
+	int i;
+
+	for (i = 0; i < YM_DELTAT_CACHE_NR; i++)
+	{
+		YM_DELTAT_CACHE *cache = &DELTAT->cache[i];
+		if (cache->length && cache->lo <= addr && addr <= cache->hi)
+		{
+			cache->length = 0;
+			if (DELTAT->cache_now == cache) DELTAT->cache_now = NULL;
+		}
+	}
+}
+
+void YM_DELTAT_cache_free(YM_DELTAT *DELTAT)
+{
+	int i;
+
+	for (i = 0; i < YM_DELTAT_CACHE_NR; i++)
+	{
+		YM_DELTAT_CACHE *cache = &DELTAT->cache[i];
+		free(cache->acc);
+		free(cache->adpcmd);
+		free(cache->src);
+		memset(cache, 0, sizeof(*cache));
+	}
+	DELTAT->cache_now = NULL;
+}
+#endif	/* QUASI88 */
+
 /* 0-DRAM x1, 1-ROM, 2-DRAM x8, 3-ROM (3 is bad setting - not allowed by the manual) */
 static UINT8 dram_rightshift[4]={3,0,0,0};
 
@@ -244,6 +361,12 @@ value:   START, REC, MEMDAT, REPEAT, SPOFF, x,x,RESET   meaning:
 					DELTAT->PCM_BSY = 0;
 				}
 			}
+#if 1	/* QUASI88 */
+			if ( (DELTAT->portstate & 0xe0)==0xa0 )
+				ym_deltat_cache_select(DELTAT);
+			else
+				DELTAT->cache_now = NULL;
+#endif	/* QUASI88 */
 		}
 		else	/* we access CPU memory (ADPCM data register $08) so we only reset now_addr here */
 		{
@@ -340,6 +463,9 @@ value:   START, REC, MEMDAT, REPEAT, SPOFF, x,x,RESET   meaning:
 			if ( DELTAT->now_addr != (DELTAT->end<<1) )
 			{
 				DELTAT->memory[DELTAT->now_addr>>1] = v;
+#if 1	/* QUASI88 */
+				ym_deltat_cache_written(DELTAT, DELTAT->now_addr>>1);
+#endif	/* QUASI88 */
 			 	DELTAT->now_addr+=2; /* two nibbles at a time */
 
 				/* reset BRDY bit in status register, which means we are processing the write */
@@ -433,6 +559,9 @@ void YM_DELTAT_ADPCM_Reset(YM_DELTAT *DELTAT,int pan,int emulation_mode)
 	DELTAT->portstate = (emulation_mode == YM_DELTAT_EMULATION_MODE_YM2610) ? 0x20 : 0;
 	DELTAT->control2  = (emulation_mode == YM_DELTAT_EMULATION_MODE_YM2610) ? 0x01 : 0;	/* default setting depends on the emulation mode. MSX demo called "facdemo_4" doesn't setup control2 register at all and still works */
 	DELTAT->DRAMportshift = dram_rightshift[DELTAT->control2 & 3];
+#if 1	/* QUASI88 */
+	DELTAT->cache_now = NULL;
+#endif	/* QUASI88 */
 
 	/* The flag mask register disables the BRDY after the reset, however
     ** as soon as the mask is enabled the flag needs to be set. */
@@ -483,6 +612,10 @@ INLINE void YM_DELTAT_synthesis_from_external_memory(YM_DELTAT *DELTAT)
 {
 	UINT32 step;
 	int data;
+#if 1	/* QUASI88 */
+	YM_DELTAT_CACHE *cache;
+	UINT32 addr;
+#endif	/* QUASI88 */
 
 	DELTAT->now_step += DELTAT->step;
 	if ( DELTAT->now_step >= (1<<YM_DELTAT_SHIFT) )
@@ -503,6 +636,9 @@ INLINE void YM_DELTAT_synthesis_from_external_memory(YM_DELTAT *DELTAT)
 					DELTAT->acc      = 0;
 					DELTAT->adpcmd   = YM_DELTAT_DELTA_DEF;
 					DELTAT->prev_acc = 0;
+#if 1	/* QUASI88 */
+					DELTAT->cache_pos = 0;
+#endif	/* QUASI88 */
 				}else{
 					/* set EOS bit in status register */
 					if(DELTAT->status_set_handler)
@@ -530,6 +666,24 @@ INLINE void YM_DELTAT_synthesis_from_external_memory(YM_DELTAT *DELTAT)
 				data = DELTAT->now_data >> 4;
 			}
 
+#if 1	/* QUASI88 */
+			addr  = DELTAT->now_addr >> 1;
+			cache = DELTAT->cache_now;
+			if ( cache && DELTAT->cache_pos < cache->length &&
+				 ( (DELTAT->cache_pos & 1) ||
+				   cache->src[DELTAT->cache_pos >> 1] == DELTAT->now_data ) )
+			{
+				/* already decoded : replay the cached values */
+				DELTAT->now_addr++;
+				DELTAT->now_addr &= ( (1<<(24+1))-1);
+				DELTAT->prev_acc = DELTAT->acc;
+				DELTAT->acc      = cache->acc[DELTAT->cache_pos];
+				DELTAT->adpcmd   = cache->adpcmd[DELTAT->cache_pos];
+				DELTAT->cache_pos++;
+				continue;
+			}
+#endif	/* QUASI88 */
+
 			DELTAT->now_addr++;
 			/* 12-06-2001 JB: */
 			/* YM2610 address register is 24 bits wide.*/
@@ -552,6 +706,11 @@ INLINE void YM_DELTAT_synthesis_from_external_memory(YM_DELTAT *DELTAT)
 			/* ElSemi: Fix interpolator. */
 			/*DELTAT->prev_acc = prev_acc + ((DELTAT->acc - prev_acc) / 2 );*/
 
+#if 1	/* QUASI88 */
+			if ( cache )
+				ym_deltat_cache_store(DELTAT, addr);
+#endif	/* QUASI88 */
+
 		}while(--step);
 
 	}
@@ -9,6 +9,22 @@
 
 typedef void (*STATUS_CHANGE_HANDLER)(void *chip, UINT8 status_bits);
 
+#if 1	/* QUASI88 */
+#define YM_DELTAT_CACHE_NR	(8)
+
+/* decoded nibbles of a sample played from external memory */
+typedef struct deltat_cache {
+	UINT32	start;			/* start address of the sample	*/
+	UINT32	lo, hi;			/* memory range (bytes) decoded	*/
+	UINT32	length;			/* number of decoded nibbles	*/
+	UINT32	size;			/* number of allocated nibbles	*/
+	UINT32	used;			/* LRU stamp			*/
+	INT16	*acc;			/* acc after each nibble	*/
+	INT16	*adpcmd;		/* adpcmd after each nibble	*/
+	UINT8	*src;			/* source byte of each 2 nibbles */
+} YM_DELTAT_CACHE;
+#endif	/* QUASI88 */
+
 
 /* DELTA-T (adpcm type B) struct */
 typedef struct deltat_adpcm_state {     /* AT: rearranged and tigntened structure */
@@ -67,6 +83,13 @@ typedef struct deltat_adpcm_state {     /* AT: rearranged and tigntened structur
 
 	UINT8	reg[16];		/* adpcm registers      */
 	UINT8	emulation_mode;	/* which chip we're emulating */
+
+#if 1	/* QUASI88 */
+	YM_DELTAT_CACHE	cache[YM_DELTAT_CACHE_NR];	/* decode cache */
+	YM_DELTAT_CACHE	*cache_now;	/* entry of the sample being played */
+	UINT32	cache_pos;		/* nibbles played from the start */
+	UINT32	cache_stamp;	/* LRU counter */
+#endif	/* QUASI88 */
 }YM_DELTAT;
 
 /*void YM_DELTAT_BRDY_callback(YM_DELTAT *DELTAT);*/
@@ -78,5 +101,8 @@ void YM_DELTAT_ADPCM_CALC(YM_DELTAT *DELTAT);
 
 void YM_DELTAT_postload(YM_DELTAT *DELTAT,UINT8 *regs);
 void YM_DELTAT_savestate(const char *statename,int num,YM_DELTAT *DELTAT);
+#if 1	/* QUASI88 */
+void YM_DELTAT_cache_free(YM_DELTAT *DELTAT);
+#endif	/* QUASI88 */
 
 #endif
@@ -11,6 +11,7 @@
 
 #include "driver.h"
 #include "streams.h"
+#include "sndsimd.h"	/* QUASI88 */
 #include <math.h>
 
 #define VERBOSE			(0)
@@ -34,12 +35,27 @@
 #define FRAC_ONE						(1 << FRAC_BITS)
 #define FRAC_MASK						(FRAC_ONE - 1)
 
+/* QUASI88 */
+#define FIR_MAX_TAPS					64
+#define FIR_MAX_FILTERS					16
+#define FIR_PHASES						(1 << SNDSIMD_FIR_PHASE_BITS)
+
 
 
 /***************************************************************************
     TYPE DEFINITIONS
 ***************************************************************************/
 
+typedef struct _resample_fir resample_fir;	/* QUASI88 */
+struct _resample_fir
+{
+	UINT32			step_frac;					/* source stepping rate this filter was designed for */
+	int				quality;					/* resample_quality this filter was designed for */
+	int				taps;						/* taps per phase (multiple of SNDSIMD_FIR_TAPS_ALIGN) */
+	float *			coef;						/* FIR_PHASES * taps coefficients */
+};
+
+
 struct stream_input
 {
 	sound_stream *stream;						/* pointer to the input stream */
@@ -50,6 +66,9 @@ struct stream_input
 	UINT32			resample_in_pos;			/* resample index where next sample will be written */
 	UINT32			resample_out_pos;			/* resample index where next sample will be read */
 	INT16			gain;						/* gain to apply to this input */
+	resample_fir *	fir;						/* polyphase filter, or NULL for the fast path */	/* QUASI88 */
+	UINT32			fir_step_frac;				/* step_frac the filter was looked up for */	/* QUASI88 */
+	int				fir_quality;				/* resample_quality the filter was looked up for */	/* QUASI88 */
 };
 
 
@@ -100,6 +119,9 @@ static sound_stream *stream_head;
 static void *stream_current_tag;
 static int stream_index;
 
+static resample_fir fir_filters[FIR_MAX_FILTERS];	/* QUASI88 */
+static int fir_filter_count;
+
 
 
 /***************************************************************************
@@ -108,6 +130,7 @@ static int stream_index;
 
 static void stream_generate_samples(sound_stream *stream, int samples);
 static void resample_input_stream(struct stream_input *input, int samples);
+static resample_fir *resample_get_fir(struct stream_input *input);	/* QUASI88 */
 
 
 
@@ -128,6 +151,10 @@ int streams_init(void)
 	stream_current_tag = NULL;
 	stream_index = 0;
 
+	/* the coefficients were auto_malloc'ed and freed with the previous session */	/* QUASI88 */
+	memset(fir_filters, 0, sizeof(fir_filters));
+	fir_filter_count = 0;
+
 	return 0;
 }
 
@@ -588,8 +615,16 @@ static void stream_generate_samples(sound_stream *stream, int samples)
 			target_source_frac = input->source_frac + resample_samples_needed * input->step_frac;
 
 			/* if we're undersampling, we need an extra sample for linear interpolation */
+#if 0		/* QUASI88 */
 			if (input->step_frac < FRAC_ONE)
 				target_source_frac += FRAC_ONE;
+#else		/* QUASI88 */
+			/* the polyphase filter reads taps samples ahead of the position */
+			if (resample_get_fir(input) != NULL)
+				target_source_frac += input->fir->taps << FRAC_BITS;
+			else if (input->step_frac < FRAC_ONE)
+				target_source_frac += FRAC_ONE;
+#endif		/* QUASI88 */
 
 			/* based on that, we know how many additional source samples we need to generate */
 #if		defined(macintosh) && defined(__SC__)		/* QUASI88 (for SC ...) */
@@ -657,8 +692,16 @@ static void resample_input_stream(struct stream_input *input, int samples)
 
 	VPRINTF(("    resample_input_stream -- step = %d\n", step));
 
+	/* QUASI88 : band-limited polyphase filter, a whole block at a time */
+	if (resample_get_fir(input) != NULL)
+	{
+		sndsimd_resample_fir(dest, source, pos, step, FRAC_BITS, input->fir->coef, input->fir->taps, gain, samples);
+		dest += samples;
+		pos += step * samples;
+	}
+
 	/* perfectly matching */
-	if (step == FRAC_ONE)
+	else if (step == FRAC_ONE)
 	{
 		while (samples--)
 		{
@@ -716,3 +759,85 @@ static void resample_input_stream(struct stream_input *input, int samples)
 	input->resample_in_pos = dest - input->resample;
 	input->source_frac = pos;
 }
+
+
+
+/*************************************
+ *
+ *  Find (or design) the polyphase
+ *  filter for an input    (QUASI88)
+ *
+ *************************************/
+
+static resample_fir *resample_get_fir(struct stream_input *input)
+{
+	UINT32 step = input->step_frac;
+	double ratio, scale, cutoff, halfwidth;
+	resample_fir *fir;
+	int taps, phase, k, i;
+
+	/* cached from the last call? */
+	if (input->fir_step_frac == step && input->fir_quality == resample_quality)
+		return input->fir;
+	input->fir_step_frac = step;
+	input->fir_quality = resample_quality;
+	input->fir = NULL;
+
+	/* matching rates need no filtering; quality 0 keeps the original interpolators */
+	if (resample_quality <= 0 || step == 0 || step == FRAC_ONE)
+		return NULL;
+
+	/* share filters between inputs with the same ratio */
+	for (i = 0; i < fir_filter_count; i++)
+		if (fir_filters[i].step_frac == step && fir_filters[i].quality == resample_quality)
+			return input->fir = &fir_filters[i];
+
+	/* the filter spans 8 (normal) or 16 (high) output samples */
+	ratio = (double)step / FRAC_ONE;
+	scale = (ratio > 1.0) ? ratio : 1.0;
+	halfwidth = (resample_quality >= 2) ? 8.0 : 4.0;
+	taps = (int)ceil(2.0 * halfwidth * scale);
+	taps = (taps + SNDSIMD_FIR_TAPS_ALIGN - 1) & ~(SNDSIMD_FIR_TAPS_ALIGN - 1);
+
+	/* heavy decimation falls back to the energy-summing path */
+	if (taps > FIR_MAX_TAPS || fir_filter_count >= FIR_MAX_FILTERS)
+		return NULL;
+
+	fir = &fir_filters[fir_filter_count++];
+	fir->step_frac = step;
+	fir->quality = resample_quality;
+	fir->taps = taps;
+	fir->coef = auto_malloc(FIR_PHASES * taps * sizeof(*fir->coef));
+
+	/* Blackman-windowed sinc, cut off just below the lower of the two Nyquist rates */
+	cutoff = 0.45 / scale;
+	for (phase = 0; phase < FIR_PHASES; phase++)
+	{
+		float *c = &fir->coef[phase * taps];
+		double frac = (double)phase / FIR_PHASES;
+		double sum = 0;
+
+		for (k = 0; k < taps; k++)
+		{
+			double t = k - (taps / 2 - 1) - frac;
+			double u = t / (taps / 2);
+			double h = 0;
+
+			if (u > -1.0 && u < 1.0)
+			{
+				double x = 2.0 * cutoff * t;
+				h = (x == 0) ? 1.0 : sin(3.14159265358979323846 * x) / (3.14159265358979323846 * x);
+				h *= 0.42 + 0.5 * cos(3.14159265358979323846 * u) + 0.08 * cos(2.0 * 3.14159265358979323846 * u);
+			}
+			c[k] = h;
+			sum += h;
+		}
+
+		/* unity gain at DC for every phase */
+		for (k = 0; k < taps; k++)
+			c[k] /= sum;
+	}
+
+	VPRINTF(("    resample_get_fir -- step = %d, taps = %d\n", step, taps));
+	return input->fir = fir;
+}
@@ -199,6 +199,15 @@ int osd_update_audio_stream(INT16 *buffer)
 	return sound_samples_per_frame;
 }
 
+#if 1		/* QUASI88 */
+int osd_update_audio_stream_part(INT16 *buffer, int samples)
+{
+	/* the stream FIFO is only drained once a frame, by
+	   osd_update_video_and_audio(), so there's nothing to gain */
+	return 0;
+}
+#endif		/* QUASI88 */
+
 void osd_stop_audio_stream(void)
 {
 	if(sysdep_sound_mixer)
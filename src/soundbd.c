@@ -16,6 +16,7 @@
 
 #include "snddrv.h"
 #include "suspend.h"
+#include "stats.h"
 
 
 /*
@@ -193,6 +194,7 @@ void	sound_out_data( byte data )
 
   sound_reg[ sound_reg_select ] = data;
 
+  STATS_INC( STATS_SOUND_REG );
   xmame_dev_sound_out_data( data );
 
 
@@ -316,6 +318,7 @@ void	sound2_out_data( byte data )
 
   sound2_reg[ sound2_reg_select ] = data;
 
+  STATS_INC( STATS_SOUND_REG );
   xmame_dev_sound2_out_data( data );
 
 /*
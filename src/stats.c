@@ -0,0 +1,124 @@
+/************************************************************************/
+/*									*/
+/* 動作状況カウンタ							*/
+/*									*/
+/************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "quasi88.h"
+#include "stats.h"
+#include "intr.h"		/* vsync_freq_hz	*/
+#include "status.h"
+
+
+unsigned long	stats_count[ STATS_END ];
+
+char	*file_stats     = NULL;		/* JSON の出力先ファイル	*/
+int	stats_interval  = 1;		/* 集計間隔 [秒]		*/
+int	stats_disp      = FALSE;	/* 真ならステータス部に表示	*/
+
+
+static const char *stats_name[ STATS_END ] =
+{
+    "main_insn",
+    "sub_insn",
+    "basic_insn",
+    "main_read_0000",
+    "main_read_8000",
+    "main_read_8400",
+    "main_read_c000",
+    "main_write_0000",
+    "main_write_8000",
+    "main_write_8400",
+    "main_write_c000",
+    "vram_write",
+    "alu_write",
+    "fdc_read",
+    "fdc_write",
+    "disk_inflate",
+    "sound_reg",
+    "frame",
+    "frame_skip",
+    "wait_late",
+    "audio_underrun",
+    "audio_sync_wait",
+    "audio_sync_rush",
+    "audio_drift_over",
+    "audio_drift_under",
+};
+
+static	unsigned long	stats_prev[ STATS_END ];	/* 前回集計時の値 */
+static	unsigned long	stats_rate[ STATS_END ];	/* 前回の間隔の増分 */
+static	int		stats_frames;			/* 集計後のフレーム数 */
+
+
+
+/*----------------------------------------------------------------------
+ * 現在の累計値と、直前の集計間隔での増分を、JSON 形式で buf にセット
+ *	buf は STATS_JSON_SIZE バイト以上のこと。戻り値は、セットした文字数
+ *----------------------------------------------------------------------*/
+int	stats_json(char *buf)
+{
+    int i, len;
+
+    len = sprintf(buf, "{\"interval\":%d,\"total\":{", stats_interval);
+    for (i = 0; i < STATS_END; i++) {
+	len += sprintf(buf + len, "%s\"%s\":%lu",
+		       (i) ? "," : "", stats_name[i], stats_count[i]);
+    }
+    len += sprintf(buf + len, "},\"delta\":{");
+    for (i = 0; i < STATS_END; i++) {
+	len += sprintf(buf + len, "%s\"%s\":%lu",
+		       (i) ? "," : "", stats_name[i], stats_rate[i]);
+    }
+    len += sprintf(buf + len, "}}\n");
+
+    return len;
+}
+
+
+
+/*----------------------------------------------------------------------
+ * 1フレーム毎に呼び出す。集計間隔が経過したら、出力する
+ *----------------------------------------------------------------------*/
+void	stats_update(void)
+{
+    char buf[ STATS_JSON_SIZE ];
+    FILE *fp;
+    int  i;
+
+    STATS_INC(STATS_FRAME);
+
+    if (file_stats == NULL && stats_disp == FALSE) return;
+
+    if (++ stats_frames < stats_interval * vsync_freq_hz) return;
+    stats_frames = 0;
+
+    for (i = 0; i < STATS_END; i++) {
+	stats_rate[i] = stats_count[i] - stats_prev[i];
+	stats_prev[i] = stats_count[i];
+    }
+
+    if (file_stats) {		/* 毎回、最新の内容で上書きする */
+	if ((fp = fopen(file_stats, "w"))) {
+	    stats_json(buf);
+	    fputs(buf, fp);
+	    fclose(fp);
+	}
+    }
+
+    if (stats_disp) {
+	sprintf(buf, "%.1fM/%.1fM draw%lu/%lu late%lu ur%lu sync%lu/%lu",
+		stats_rate[ STATS_MAIN_INSN ] / 1000000.0 / stats_interval,
+		stats_rate[ STATS_SUB_INSN ]  / 1000000.0 / stats_interval,
+		stats_rate[ STATS_FRAME ] - stats_rate[ STATS_FRAME_SKIP ],
+		stats_rate[ STATS_FRAME ],
+		stats_rate[ STATS_WAIT_LATE ],
+		stats_rate[ STATS_AUDIO_UNDERRUN ],
+		stats_rate[ STATS_AUDIO_SYNC_WAIT ],
+		stats_rate[ STATS_AUDIO_SYNC_RUSH ]);
+	status_message(1, (int) (stats_interval * vsync_freq_hz) + 2, buf);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef STATS_H_INCLUDED
+#define STATS_H_INCLUDED
+
+
+/*----------------------------------------------------------------------
+ * ư
+ *	ۥåȥѥǷΡͭʥ󥿡
+ *	׷̤ϡֳ֤ JSON ե˽Ϥꡢơ
+ *	ɽǤ롣
+ *
+ *	ƥ󥿤򹹿Τ 1ĤΥåɤ (ǥ
+ *	ΤߡǥΥХå¦) ʤΤǡåס
+ *	ɤ߽Ф¦ϡ¿줿ͤɤǤⵤˤʤ
+ *----------------------------------------------------------------------*/
+
+enum {
+    STATS_MAIN_INSN,		/* ᥤCPU ̿			*/
+    STATS_SUB_INSN,		/* CPU   ̿			*/
+    STATS_BASIC_INSN,		/* BASICѴѤβCPU ̿		*/
+
+    STATS_MAIN_READ_0000,	/* ᥤ ꡼ 00007FFF	*/
+				/* (եåޤ礬)		*/
+    STATS_MAIN_READ_8000,	/*		       800083FF	*/
+    STATS_MAIN_READ_8400,	/*		       8400BFFF	*/
+    STATS_MAIN_READ_C000,	/*		       C000FFFF	*/
+    STATS_MAIN_WRITE_0000,	/* ᥤ 饤 00007FFF	*/
+    STATS_MAIN_WRITE_8000,	/*		       800083FF	*/
+    STATS_MAIN_WRITE_8400,	/*		       8400BFFF	*/
+    STATS_MAIN_WRITE_C000,	/*		       C000FFFF	*/
+
+    STATS_VRAM_WRITE,		/* VRAM 饤 (Х)		*/
+    STATS_ALU_WRITE,		/* VRAM 饤 (ALUͳ)		*/
+
+    STATS_FDC_READ,		/* FDC ꡼			*/
+    STATS_FDC_WRITE,		/* FDC 饤			*/
+    STATS_DISK_INFLATE,		/* ̥᡼Υ֥åŸ		*/
+
+    STATS_SOUND_REG,		/* åפΥ쥸񤭹		*/
+
+    STATS_FRAME,		/* ե졼				*/
+    STATS_FRAME_SKIP,		/* 򥹥åפե졼		*/
+    STATS_WAIT_LATE,		/* Ȥ֤˹ʤäե졼	*/
+    STATS_AUDIO_UNDERRUN,	/* ǥΥ		*/
+    STATS_AUDIO_SYNC_WAIT,	/* Ԥ¿ޤԤä	*/
+    STATS_AUDIO_SYNC_RUSH,	/* ԤʤԤ˿ʤ᤿	*/
+    STATS_AUDIO_DRIFT_OVER,	/* ԤɸΤ [ץ]	*/
+    STATS_AUDIO_DRIFT_UNDER,	/*	(Ķʬ­ʬΡ줾߷)	*/
+
+    STATS_END
+};
+
+extern	unsigned long	stats_count[ STATS_END ];
+
+#define	STATS_INC(id)		(stats_count[ id ] ++)
+#define	STATS_ADD(id, n)	(stats_count[ id ] += (n))
+
+
+extern	char	*file_stats;		/* JSON νե	*/
+extern	int	stats_interval;		/* ״ֳ []		*/
+extern	int	stats_disp;		/* ʤ饹ơɽ	*/
+
+void	stats_update(void);
+
+#define	STATS_JSON_SIZE		(2048)	/* stats_json() ΥХåե	*/
+int	stats_json(char *buf);
+
+
+#endif	/* STATS_H_INCLUDED */
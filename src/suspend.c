@@ -15,6 +15,7 @@
 #include "suspend.h"
 #include "initval.h"
 #include "file-op.h"
+#include "machine.h"
 
 int	resume_flag  = FALSE;			/* 起動時のレジューム	*/
 int	resume_force = FALSE;			/* 強制レジューム	*/
@@ -308,6 +309,8 @@ int	statesave_table( const char id[4], T_SUSPEND_W *tbl )
   if( write_id( fp, id, size ) != size ) return STATE_ERR;
 
   for( ;; ){
+    void *work = machine_relocate( tbl->work );	/* 処理中のマシンのワーク */
+
     switch( tbl->type ){
 
     case TYPE_END:
@@ -315,33 +318,33 @@ int	statesave_table( const char id[4], T_SUSPEND_W *tbl )
 
     case TYPE_INT:
     case TYPE_LONG:
-      if( statesave_int( fp, (int *)tbl->work )==FALSE ) return STATE_ERR;
+      if( statesave_int( fp, (int *)work )==FALSE ) return STATE_ERR;
       break;
 
     case TYPE_SHORT:
     case TYPE_WORD:
-      if( statesave_short( fp, (short *)tbl->work )==FALSE ) return STATE_ERR;
+      if( statesave_short( fp, (short *)work )==FALSE ) return STATE_ERR;
       break;
 
     case TYPE_CHAR:
     case TYPE_BYTE:
-      if( statesave_char( fp, (char *)tbl->work )==FALSE ) return STATE_ERR;
+      if( statesave_char( fp, (char *)work )==FALSE ) return STATE_ERR;
       break;
 
     case TYPE_PAIR:
-      if( statesave_pair( fp, (pair *)tbl->work )==FALSE ) return STATE_ERR;
+      if( statesave_pair( fp, (pair *)work )==FALSE ) return STATE_ERR;
       break;
 
     case TYPE_DOUBLE:
-      if( statesave_double( fp, (double *)tbl->work )==FALSE) return STATE_ERR;
+      if( statesave_double( fp, (double *)work )==FALSE) return STATE_ERR;
       break;
 
     case TYPE_STR:
-      if( statesave_str( fp, (char *)tbl->work )==FALSE ) return STATE_ERR;
+      if( statesave_str( fp, (char *)work )==FALSE ) return STATE_ERR;
       break;
 
     case TYPE_256:
-      if( statesave_256( fp, (char *)tbl->work )==FALSE ) return STATE_ERR;
+      if( statesave_256( fp, (char *)work )==FALSE ) return STATE_ERR;
       break;
 
     default:	return STATE_ERR;
@@ -441,6 +444,8 @@ int	stateload_table( const char id[4], T_SUSPEND_W *tbl )
   if( s == -2 )   return STATE_ERR_ID;
 
   for( ;; ){
+    void *work = machine_relocate( tbl->work );	/* 処理中のマシンのワーク */
+
     switch( tbl->type ){
 
     case TYPE_END:
@@ -449,39 +454,39 @@ int	stateload_table( const char id[4], T_SUSPEND_W *tbl )
 
     case TYPE_INT:
     case TYPE_LONG:
-      if( stateload_int( fp, (int *)tbl->work )==FALSE ) return STATE_ERR;
+      if( stateload_int( fp, (int *)work )==FALSE ) return STATE_ERR;
       size += 4;
       break;
 
     case TYPE_SHORT:
     case TYPE_WORD:
-      if( stateload_short( fp, (short *)tbl->work )==FALSE ) return STATE_ERR;
+      if( stateload_short( fp, (short *)work )==FALSE ) return STATE_ERR;
       size += 2;
       break;
 
     case TYPE_CHAR:
     case TYPE_BYTE:
-      if( stateload_char( fp, (char *)tbl->work )==FALSE ) return STATE_ERR;
+      if( stateload_char( fp, (char *)work )==FALSE ) return STATE_ERR;
       size += 1;
       break;
 
     case TYPE_PAIR:
-      if( stateload_pair( fp, (pair *)tbl->work )==FALSE ) return STATE_ERR;
+      if( stateload_pair( fp, (pair *)work )==FALSE ) return STATE_ERR;
       size += 2;
       break;
 
     case TYPE_DOUBLE:
-      if( stateload_double( fp, (double *)tbl->work )==FALSE) return STATE_ERR;
+      if( stateload_double( fp, (double *)work )==FALSE) return STATE_ERR;
       size += 4;
       break;
 
     case TYPE_STR:
-      if( stateload_str( fp, (char *)tbl->work )==FALSE ) return STATE_ERR;
+      if( stateload_str( fp, (char *)work )==FALSE ) return STATE_ERR;
       size += 1024;
       break;
 
     case TYPE_256:
-      if( stateload_256( fp, (char *)tbl->work )==FALSE ) return STATE_ERR;
+      if( stateload_256( fp, (char *)work )==FALSE ) return STATE_ERR;
       size += 256;
       break;
 
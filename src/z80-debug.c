@@ -8,6 +8,7 @@
 
 #include "quasi88.h"
 #include "z80.h"
+#include "pc88cpu.h"
 
 
 /*
@@ -1649,9 +1650,6 @@ static	int	log_line_disasm( z80arch *z80, word pc )
 
 void	z80_logging(z80arch *z80)
 {
-    extern z80arch z80main_cpu;
-    extern z80arch z80sub_cpu;
-
     if (main_debug && z80 == &z80main_cpu) {
 	logz80_target(main_debug);
 	logz80("[MAIN] ");
@@ -0,0 +1,324 @@
+/************************************************************************/
+/*									*/
+/* Z80 ステート数プロファイラ						*/
+/*									*/
+/************************************************************************/
+
+/*
+  エミュレートしている Z80 のプログラムが、どこでステート数を消費して
+  いるのかを調べるためのもの。
+
+  ○サンプリング
+	z80_emu() で割込更新 (z80->intr_update) を呼び出した直後に、
+	その区間で実行したステート数 (z80->state0) を、その時点の PC と
+	コールスタックに加算する。命令毎には何もしないので、負荷は小さい。
+
+  ○コールスタック
+	CALL / RST / 割込応答 で、分岐先とスタックポインタを記録し、
+	RET で SP がその位置より上に戻ったら取り除く。POP で戻り番地を
+	捨てるような処理も、SP の位置で判断するので、そのうち整合が取れる。
+	深さが Z80PROF_DEPTH を超えた分は記録しない。
+
+  ○出力 (終了時)
+	quasi88.main.prof   … 関数 (分岐先アドレス) 毎のステート数、
+	quasi88.sub.prof       および PC 毎のステート数の上位
+	quasi88.main.stacks … コールスタック毎のステート数
+	quasi88.sub.stacks     (flamegraph.pl にそのまま渡せる形式)
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "quasi88.h"
+#include "z80.h"
+#include "z80-prof.h"
+#include "pc88cpu.h"
+
+
+int	z80prof_mode = 0;		/* bit0: メインCPU, bit1: サブCPU */
+
+
+#define	Z80PROF_DEPTH	(32)		/* 記録するコールスタックの深さ	*/
+#define	Z80PROF_HASH	(8192)		/* 記録するコールスタックの種類	*/
+#define	Z80PROF_TOP	(64)		/* 関数・PC の上位の出力数	*/
+
+typedef	struct {
+    int		depth;			/* 0 なら未使用			*/
+    word	frame[ Z80PROF_DEPTH ];	/* 各段の関数アドレス		*/
+    double	state;
+} T_PROF_STACK;
+
+struct	z80prof {
+    const char	*name;			/* "main" / "sub"		*/
+
+    int		depth;			/* コールスタック		*/
+    struct {
+	word	target;			/*	分岐先アドレス		*/
+	word	sp;			/*	戻り番地を積んだ SP	*/
+    } stack[ Z80PROF_DEPTH ];
+
+    double	total;			/* 総ステート数			*/
+    long	samples;		/* サンプル数			*/
+
+    double	*pc_state;		/* PC 毎のステート数 [0x10000]	*/
+    double	*self_state;		/* 関数毎 (自身のみ) [0x10000]	*/
+    double	*incl_state;		/* 関数毎 (呼出先含) [0x10000]	*/
+    double	root_state;		/* 関数外 (スタック空) の分	*/
+
+    T_PROF_STACK *stacks;		/* コールスタック毎 [Z80PROF_HASH] */
+    double	lost_state;		/* 記録しきれなかった分		*/
+};
+
+
+static	struct z80prof	*prof_alloc(const char *name)
+{
+    struct z80prof *p = (struct z80prof *)calloc(1, sizeof(struct z80prof));
+
+    if (p) {
+	p->name       = name;
+	p->pc_state   = (double *)calloc(0x10000, sizeof(double));
+	p->self_state = (double *)calloc(0x10000, sizeof(double));
+	p->incl_state = (double *)calloc(0x10000, sizeof(double));
+	p->stacks     = (T_PROF_STACK *)calloc(Z80PROF_HASH,
+					       sizeof(T_PROF_STACK));
+
+	if (p->pc_state == NULL || p->self_state == NULL ||
+	    p->incl_state == NULL || p->stacks == NULL) {
+	    free(p->pc_state);
+	    free(p->self_state);
+	    free(p->incl_state);
+	    free(p->stacks);
+	    free(p);
+	    p = NULL;
+	}
+    }
+    return p;
+}
+
+static	void	prof_free(struct z80prof *p)
+{
+    free(p->pc_state);
+    free(p->self_state);
+    free(p->incl_state);
+    free(p->stacks);
+    free(p);
+}
+
+
+/*----------------------------------------------------------------------
+ * コールスタックの更新 (CALL / RST / 割込応答 / RET 時)
+ *----------------------------------------------------------------------*/
+void	z80prof_call(struct z80prof *p, word target, word sp)
+{
+    /* 今回戻り番地を積んだ位置以下にある記録は、もう無効 */
+    while (p->depth > 0 && p->stack[ p->depth - 1 ].sp <= sp) {
+	p->depth --;
+    }
+
+    if (p->depth < Z80PROF_DEPTH) {
+	p->stack[ p->depth ].target = target;
+	p->stack[ p->depth ].sp     = sp;
+	p->depth ++;
+    }
+}
+
+void	z80prof_ret(struct z80prof *p, word sp)
+{
+    /* 戻り番地を積んだ位置より SP が上に戻ったら、その関数は終了 */
+    while (p->depth > 0 && p->stack[ p->depth - 1 ].sp < sp) {
+	p->depth --;
+    }
+}
+
+
+/*----------------------------------------------------------------------
+ * サンプリング (割込更新毎)
+ *----------------------------------------------------------------------*/
+static	void	prof_add_stack(struct z80prof *p, double state)
+{
+    bit32 h = 2166136261u;
+    int   i, n;
+    T_PROF_STACK *s;
+
+    for (i = 0; i < p->depth; i++) {		/* FNV-1a */
+	h = (h ^ p->stack[i].target) * 16777619u;
+    }
+
+    for (n = 0; n < Z80PROF_HASH; n++) {
+	s = &p->stacks[ (h + n) & (Z80PROF_HASH - 1) ];
+
+	if (s->depth == 0) {			/* 空きなので、新規登録 */
+	    s->depth = p->depth + 1;		/* (深さ+1 を格納)	*/
+	    for (i = 0; i < p->depth; i++) {
+		s->frame[i] = p->stack[i].target;
+	    }
+	    s->state = state;
+	    return;
+	}
+	if (s->depth == p->depth + 1) {		/* 一致すれば加算	*/
+	    for (i = 0; i < p->depth; i++) {
+		if (s->frame[i] != p->stack[i].target) break;
+	    }
+	    if (i == p->depth) {
+		s->state += state;
+		return;
+	    }
+	}
+    }
+    p->lost_state += state;			/* 満杯 */
+}
+
+void	z80prof_sample(struct z80prof *p, word pc, word sp, int state)
+{
+    int i, j;
+    word target;
+
+    if (state <= 0) return;
+
+    z80prof_ret(p, sp);		/* 戻り番地を捨てられた関数を取り除く */
+
+    p->total += state;
+    p->samples ++;
+    p->pc_state[ pc ] += state;
+
+    if (p->depth == 0) {
+	p->root_state += state;
+    } else {
+	p->self_state[ p->stack[ p->depth - 1 ].target ] += state;
+    }
+
+    for (i = 0; i < p->depth; i++) {	/* 再帰呼出は、1回だけ数える */
+	target = p->stack[i].target;
+	for (j = 0; j < i; j++) {
+	    if (p->stack[j].target == target) break;
+	}
+	if (j == i) p->incl_state[ target ] += state;
+    }
+
+    prof_add_stack(p, state);
+}
+
+
+/*----------------------------------------------------------------------
+ * 結果の出力
+ *----------------------------------------------------------------------*/
+static	const double *sort_key;
+
+static	int	prof_compare(const void *a, const void *b)
+{
+    double ka = sort_key[ *(const int *)a ];
+    double kb = sort_key[ *(const int *)b ];
+
+    if (ka > kb) return -1;
+    if (ka < kb) return  1;
+    return *(const int *)a - *(const int *)b;
+}
+
+/* key[] が 0 でないものを、大きい順に並べて index[] にセット。数を返す */
+static	int	prof_sort(const double *key, int *index)
+{
+    int i, n = 0;
+
+    for (i = 0; i < 0x10000; i++) {
+	if (key[i] > 0) index[ n++ ] = i;
+    }
+    sort_key = key;
+    qsort(index, n, sizeof(int), prof_compare);
+    return n;
+}
+
+static	void	prof_output(struct z80prof *p)
+{
+    char  filename[32];
+    FILE  *fp;
+    int   *index;
+    int   i, j, n;
+    double total = (p->total > 0) ? p->total : 1;
+
+    index = (int *)malloc(sizeof(int) * 0x10000);
+    if (index == NULL) return;
+
+				/* 関数毎、PC 毎の集計 */
+    sprintf(filename, "quasi88.%s.prof", p->name);
+    if ((fp = fopen(filename, "w"))) {
+
+	fprintf(fp, "# %s CPU : %.0f states, %ld samples\n",
+		p->name, p->total, p->samples);
+
+	fprintf(fp, "\n# function    total    %%      self    %%\n");
+	n = prof_sort(p->incl_state, index);
+	for (i = 0; i < n && i < Z80PROF_TOP; i++) {
+	    j = index[i];
+	    fprintf(fp, "  %04X  %12.0f %5.1f %12.0f %5.1f\n", j,
+		    p->incl_state[j], p->incl_state[j] * 100 / total,
+		    p->self_state[j], p->self_state[j] * 100 / total);
+	}
+	fprintf(fp, "  (root)%12s %5s %12.0f %5.1f\n", "", "",
+		p->root_state, p->root_state * 100 / total);
+
+	fprintf(fp, "\n# PC          states    %%\n");
+	n = prof_sort(p->pc_state, index);
+	for (i = 0; i < n && i < Z80PROF_TOP; i++) {
+	    j = index[i];
+	    fprintf(fp, "  %04X  %12.0f %5.1f\n", j,
+		    p->pc_state[j], p->pc_state[j] * 100 / total);
+	}
+	fclose(fp);
+    }
+
+				/* コールスタック毎の集計 */
+    sprintf(filename, "quasi88.%s.stacks", p->name);
+    if ((fp = fopen(filename, "w"))) {
+
+	for (i = 0; i < Z80PROF_HASH; i++) {
+	    if (p->stacks[i].depth == 0) continue;
+
+	    fprintf(fp, "%s", p->name);
+	    for (j = 0; j < p->stacks[i].depth - 1; j++) {
+		fprintf(fp, ";%04X", p->stacks[i].frame[j]);
+	    }
+	    fprintf(fp, " %.0f\n", p->stacks[i].state);
+	}
+	if (p->lost_state > 0) {
+	    fprintf(fp, "%s;(lost) %.0f\n", p->name, p->lost_state);
+	}
+	fclose(fp);
+    }
+
+    free(index);
+}
+
+
+/*----------------------------------------------------------------------
+ * 初期化・終了
+ *----------------------------------------------------------------------*/
+void	z80prof_init(void)
+{
+    if (z80prof_mode & 1) {
+	z80main_cpu.prof = prof_alloc("main");
+    }
+    if (z80prof_mode & 2) {
+	z80sub_cpu.prof  = prof_alloc("sub");
+    }
+
+    if (z80main_cpu.prof || z80sub_cpu.prof) {
+	if (verbose_proc) printf("+ Support Z80 profiler.\n");
+    } else if (z80prof_mode) {
+	printf("Z80 profiler : memory allocate failed\n");
+    }
+}
+
+void	z80prof_exit(void)
+{
+    if (z80main_cpu.prof) {
+	prof_output(z80main_cpu.prof);
+	prof_free(z80main_cpu.prof);
+	z80main_cpu.prof = NULL;
+    }
+    if (z80sub_cpu.prof) {
+	prof_output(z80sub_cpu.prof);
+	prof_free(z80sub_cpu.prof);
+	z80sub_cpu.prof = NULL;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef Z80_PROF_H_INCLUDED
+#define Z80_PROF_H_INCLUDED
+
+
+/*----------------------------------------------------------------------
+ * ߥ졼ȤƤ Z80 Ρơȿץե
+ *	 (z80->intr_update) ˡζ֤Ǽ¹Ԥơȿ
+ *	λ PC ȡCALL/RET ꤷ륹å˲û롣
+ *	λˡؿν (quasi88.main.prof ʤ) ȡflamegraph Ѥ
+ *	륹åν (quasi88.main.stacks ʤ) Ϥ롣
+ *----------------------------------------------------------------------*/
+
+extern	int	z80prof_mode;		/* bit0: ᥤCPU, bit1: CPU */
+
+struct	z80prof;
+
+void	z80prof_init(void);
+void	z80prof_exit(void);
+
+void	z80prof_call(struct z80prof *p, word target, word sp);
+void	z80prof_ret(struct z80prof *p, word sp);
+void	z80prof_sample(struct z80prof *p, word pc, word sp, int state);
+
+
+/* z80.c ǻѤޥץե̤ѻϡݥ󥿤ȽΤ */
+
+#define	Z80PROF_CALL(z80)						\
+	do{ if( (z80)->prof )						\
+	      z80prof_call( (z80)->prof, (z80)->PC.W, (z80)->SP.W ); }while(0)
+#define	Z80PROF_RET(z80)						\
+	do{ if( (z80)->prof )						\
+	      z80prof_ret( (z80)->prof, (z80)->SP.W ); }while(0)
+#define	Z80PROF_SAMPLE(z80)						\
+	do{ if( (z80)->prof )						\
+	      z80prof_sample( (z80)->prof, (z80)->PC.W, (z80)->SP.W,	\
+			      (z80)->state0 ); }while(0)
+
+
+#endif	/* Z80_PROF_H_INCLUDED */
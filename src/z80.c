@@ -82,6 +82,8 @@
 
 #include "quasi88.h"
 #include "z80.h"
+#include "z80-prof.h"
+#include "stats.h"
 
 
 #define S_FLAG      (0x80)
@@ -250,6 +252,7 @@ void	z80_reset( z80arch *z80 )
 			  M_WRMEM( --z80->SP.W, z80->PC.B.l );		\
 			  z80->PC.W = J.W;				\
 			  z80->state0 += 7;				\
+			  Z80PROF_CALL( z80 );				\
 			}while(0)
 #define M_JP()		do{						\
 			  J.B.l = M_RDMEM( z80->PC.W++ );		\
@@ -264,11 +267,13 @@ void	z80_reset( z80arch *z80 )
 			  z80->PC.B.l = M_RDMEM( z80->SP.W++ );		\
 			  z80->PC.B.h = M_RDMEM( z80->SP.W++ );		\
 			  z80->state0 += 6;				\
+			  Z80PROF_RET( z80 );				\
 			}while(0)
 #define M_RST(addr)	do{						\
 			  M_WRMEM( --z80->SP.W, z80->PC.B.h );		\
 			  M_WRMEM( --z80->SP.W, z80->PC.B.l );		\
 			  z80->PC.W = addr;				\
+			  Z80PROF_CALL( z80 );				\
 			}while(0)
 
 
@@ -740,6 +745,7 @@ INLINE	void	z80_interrupt( z80arch *z80 )
       z80->PC.B.l = M_RDMEM( level++ );
       z80->PC.B.h = M_RDMEM( level );
       z80->state0 += 17;
+      Z80PROF_CALL( z80 );
       break;
     }
   }
@@ -775,6 +781,7 @@ int	z80_emu( z80arch *z80, int state_of_exec )
   byte	I;
   pair	J;
   int	total_state    = 0;	/* 関数終了時までに、処理したステート数	     */
+  unsigned long insn   = 0;	/* 関数終了時までに、処理した命令数	     */
 
 
   z80_state_goal = state_of_exec;
@@ -805,6 +812,7 @@ int	z80_emu( z80arch *z80, int state_of_exec )
 
       opcode = M_FETCH(z80->PC.W++);		/* 命令フェッチ */
       z80->R ++;
+      insn ++;
       z80->state0 += state_table[ opcode ];
 
       switch( opcode ){				/* 命令デコード */
@@ -839,6 +847,8 @@ int	z80_emu( z80arch *z80, int state_of_exec )
 
     (z80->intr_update)();
 
+    Z80PROF_SAMPLE( z80 );		/* プロファイラのサンプリング */
+
     total_state += z80->state0;		/* 処理した state 数の累計 */
     z80->state0  = 0;
 
@@ -877,5 +887,7 @@ int	z80_emu( z80arch *z80, int state_of_exec )
     }
   }
 
+  STATS_ADD( z80->stats_insn, insn );	/* 動作状況カウンタ (命令数) */
+
   return	total_state;
 }
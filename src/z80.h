@@ -37,6 +37,9 @@ typedef struct{
 
   pair  PC_prev;			/* ľ PC (˥)	*/
 
+  struct z80prof *prof;		/* ץե (NULLʤ̤) */
+  int	stats_insn;			/* ̿Υֹ (stats.h) */
+
 } z80arch;
 
 